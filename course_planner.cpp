@@ -28,21 +28,67 @@
 //     * Implements a Binary Search Tree data structure
 //     * Traverses the BST In Order (left to right) via recursive algorithm
 //     * Inserts a new node into the BST
+//     * Adds, updates and deletes courses in the loaded BST at runtime, recording
+//       every edit in a write-ahead log which is replayed over the csv data on the
+//       next load and periodically compacted to one record per edited course
+//     * Imports a file of course edits in groups which each cost a single fsync
+//     * Bulk builds a perfectly balanced BST from the csv data in O(n) once the
+//       courses are sorted (and skips the sort if the file is already sorted)
 //     * Populates each new node with data for the Course objects used in this 
 //       program
 //     * Searches for Course objects within the BST
+//     * Computes which courses each student in a batch is eligible to take next,
+//       using bitsets of completed courses and prerequisites, spread across
+//       worker threads which steal work from each other
 //     * Retrieves and Prints Course information based on project specifications
 //     * Reads data from a csv file and loading it into the BST
+//     * Splits csv lines into cells 64 characters at a time using SSE2 bitmasks
+//       (with a scalar fallback for compilers/targets without SSE2)
+//     * Hosts several named catalogs at once in a registry which stores every
+//       course number, title and prerequisite once in a shared string pool
 //     * Implements a text-based user interface based on project specifications
 //     * Implements input validation and error handling
 //
 /////////////////////////////////////////////////////////////////////////////////////
 
 
+// The edit log uses the C file API so it can fsync; allow fopen under MSVC's SDL checks
+#if defined(_MSC_VER) && !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
 #include <iostream>
 #include <string>
 #include <vector>
 #include <fstream>
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+
+// SSE2 is part of the x86-64 baseline, so it is available on every 64-bit build.
+// The scalar mask builder is always compiled too; SplitLine uses it on targets
+// without SSE2, or when SetSimdMasks(false) is called (the tests use this to
+// compare the two).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COURSE_PLANNER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
 
 
 // ---------------------------------------
@@ -104,7 +150,22 @@ private:
     Node* root;
 
     void addNode(Node* node, Course course);
+    void destroyTree(Node* node);
     void inOrder(Node* node);
+    void collectInOrder(Node* node, std::vector<Course>& courseList);
+    unsigned int height(Node* node);
+    Node* buildBalanced(std::vector<Course>& sortedCourses, size_t first, size_t last);
+    static bool courseLess(const Course& a, const Course& b);
+    // True when SplitLine should build its bitmasks with SSE2
+    static bool simdMasks;
+
+    static void buildBlockMasksScalar(const char* block, uint64_t& quoteMask, uint64_t& commaMask);
+    static void buildBlockMasksSse2(const char* block, uint64_t& quoteMask, uint64_t& commaMask);
+    static uint64_t prefixXor(uint64_t mask);
+    static unsigned lowestSetBit(uint64_t mask);
+    Node* removeNode(Node* node, const std::string& courseNumber, bool& removed);
+    Node* detachMin(Node* node, Node*& minNode);
+    static bool readCourseDetails(Course& course);
 
 public:
 
@@ -112,14 +173,115 @@ public:
     virtual ~BinarySearchTree();
     void MainMenu(BinarySearchTree* courses, std::string csvPath);
     void LoadData(std::string csvPath, BinarySearchTree* courses);
+    static void SplitLine(const std::string& line, std::vector<std::string>& row);
+    static bool SetSimdMasks(bool enabled);
     void Insert(Course course);
+    void BulkBuild(std::vector<Course>& courseList);
     Course Search(std::string courseNumber);
+    bool Update(Course course);
+    bool Remove(std::string courseNumber);
+    void ApplyEdit(char operation, Course course);
+    static std::string CourseToCsvRow(const Course& course);
     void InsertCourses(std::vector<std::vector<std::string>> fileContent, BinarySearchTree* courses);
     void PrintSampleSchedule();
+    void CollectCourses(std::vector<Course>& courseList);
+    unsigned int Height();
     void PrintCourseInformation(BinarySearchTree* courses, std::string courseNumber);
 };
 
 
+
+// -----------------------------------------------------------------------------------
+// Write-Ahead Log Class Definition
+// Makes runtime edits to the catalog durable without rewriting the whole csv file.
+//
+// Every add, update or delete is appended to the log file before it is applied to
+// the tree.  Records are flushed to disk with a single fsync per group (a commit).
+// A single edit from the menu is its own group, while ApplyEdits (used to import a
+// file of edits) commits up to groupSize edits at a time, so a batch of edits pays
+// for one fsync per group instead of one per edit.
+//
+// The csv file is always the base of the catalog.  When the catalog is loaded, the
+// csv file is loaded, then the snapshot is replayed on top of it, then the log.  The
+// snapshot is itself a log, holding only the net effect of every edit made before
+// the last compaction: at most a delete and an update for each edited course.  So
+// changes made to the csv file by hand are picked up on the next load, and edits
+// made through the menu stay layered on top of them.  Once the log holds enough
+// records it is compacted: the net edits are written out as a new snapshot and the
+// log is emptied.
+//
+// Replaying a record is idempotent (adds and updates overwrite, deletes of a
+// missing course do nothing), so a crash part way through compaction can safely
+// replay records which are already in the snapshot.
+// -----------------------------------------------------------------------------------
+class WriteAheadLog {
+
+private:
+
+    // File paths for the log, the snapshot, and the snapshot being written or replaced
+    std::string logPath;
+    std::string snapshotPath;
+    std::string tempSnapshotPath;
+    std::string oldSnapshotPath;
+    // The open log file (nullptr until Recover is called, or after a write fails)
+    FILE* logFile;
+    // Size of the log file up to the end of the last commit
+    long committedSize;
+    // Records appended since the last fsync
+    unsigned int pendingRecords;
+    // Edits appended since the last fsync, added to the net edits once committed
+    std::vector<std::pair<char, Course>> pendingEdits;
+    // Records in the log since the last compaction
+    unsigned int loggedRecords;
+    // Largest number of edits ApplyEdits commits with one fsync
+    unsigned int groupSize;
+    // Number of logged records which triggers compaction
+    unsigned int compactThreshold;
+
+    // The net effect of every edit replayed or appended for one course number
+    struct NetEdit {
+        // True if the course was deleted at some point
+        bool deleted;
+        // True if the last edit added or updated the course (held in course)
+        bool present;
+        Course course;
+
+        NetEdit() {
+            deleted = false;
+            present = false;
+        }
+    };
+
+    // The net edits since the csv file, by course number
+    std::map<std::string, NetEdit> netEdits;
+
+    void recordEdit(char operation, const Course& course);
+    bool openLog(const char* mode);
+    void rollBack();
+    bool truncateLog(long size);
+    unsigned int replayFile(const std::string& path, BinarySearchTree* courses, long& completeSize, bool& tornRecord);
+    unsigned int replayEdits(BinarySearchTree* courses, long& completeSize, bool& tornRecord);
+    static std::string formatRecord(char operation, const Course& course);
+    static bool syncFile(FILE* file);
+    static bool syncDirectory(const std::string& path);
+    static bool fileExists(const std::string& path);
+
+public:
+
+    WriteAheadLog(std::string csvPath, unsigned int groupSize = 32, unsigned int compactThreshold = 256);
+    virtual ~WriteAheadLog();
+    void Recover(BinarySearchTree* courses, std::string csvPath);
+    static void LoadWithEdits(BinarySearchTree* courses, std::string csvPath);
+    bool Append(char operation, const Course& course);
+    bool Commit();
+    unsigned int ApplyEdits(BinarySearchTree* courses, const std::vector<std::pair<char, Course>>& edits);
+    static bool LoadEditFile(std::string editPath, std::vector<std::pair<char, Course>>& edits);
+    void CompactIfNeeded();
+    void Compact();
+    static bool ParseRecord(const std::string& record, char& operation, Course& course);
+};
+
+
 // Default Constructor for BinarySearchTree class
 // ----------------------------------------------
 BinarySearchTree::BinarySearchTree() {
@@ -133,8 +295,29 @@ BinarySearchTree::BinarySearchTree() {
 // ----------
 BinarySearchTree::~BinarySearchTree() {
 
-    // Current implementation does not include a destructor. 
-    // Need to implement in the future to prevent memory leaks.
+    // Delete every node in the tree
+    destroyTree(root);
+    root = nullptr;
+}
+
+
+// ----------------------------------------------------------------------------
+// destroyTree
+// -----------
+// Private recursive method to delete a node and every node below it.
+//
+// @param node: the root of the subtree to delete
+// ----------------------------------------------------------------------------
+void BinarySearchTree::destroyTree(Node* node) {
+
+    if (node == nullptr) {
+
+        return;
+    }
+
+    destroyTree(node->left);
+    destroyTree(node->right);
+    delete node;
 }
 
 
@@ -155,6 +338,9 @@ void BinarySearchTree::MainMenu(BinarySearchTree* courses, std::string csvPath)
     // Implemented to avoid runtime errors for trying to access data which isn't there.
     bool treeLoaded = false;
 
+    // The write-ahead log which records course edits made through the menu
+    WriteAheadLog editLog(csvPath);
+
     // Print application welcome banner
     std::cout
         << "======================================" << std::endl
@@ -172,6 +358,10 @@ void BinarySearchTree::MainMenu(BinarySearchTree* courses, std::string csvPath)
         std::cout << "  1. Load Data Structure" << std::endl;
         std::cout << "  2. Print Course List" << std::endl;
         std::cout << "  3. Print Course" << std::endl;
+        std::cout << "  4. Add Course" << std::endl;
+        std::cout << "  5. Update Course" << std::endl;
+        std::cout << "  6. Delete Course" << std::endl;
+        std::cout << "  7. Import Course Edits" << std::endl;
         std::cout << "  9. Exit" << std::endl;
         std::cout << "========================";
         std::cout << std::endl;
@@ -183,7 +373,8 @@ void BinarySearchTree::MainMenu(BinarySearchTree* courses, std::string csvPath)
             std::cin >> userMainInput;
 
             // Condition for exception handling
-            if (userMainInput != "1" && userMainInput != "2" && userMainInput != "3" && userMainInput != "9") {
+            if (userMainInput != "1" && userMainInput != "2" && userMainInput != "3" && userMainInput != "4"
+                && userMainInput != "5" && userMainInput != "6" && userMainInput != "7" && userMainInput != "9") {
 
                 throw char('a');
             }
@@ -202,11 +393,13 @@ void BinarySearchTree::MainMenu(BinarySearchTree* courses, std::string csvPath)
 
         if (userMainInput == "1") {
 
-            // Instantiate new BinarySearchTree and assign to the courses pointer variable
+            // Free any previously loaded tree, then instantiate a new BinarySearchTree
+            // and assign to the courses pointer variable
+            delete courses;
             courses = new BinarySearchTree();
 
-            // Call the LoadData method, sending the file path and the instantiated Binary Search Tree
-            LoadData(csvPath, courses);
+            // Load the newest snapshot (or the csv file) into the tree and replay any logged edits on top of it
+            editLog.Recover(courses, csvPath);
 
             // Once LoadData is finished, print success message
             std::cout << std::endl << "Data Structure loaded successfully." << std::endl;
@@ -263,12 +456,122 @@ void BinarySearchTree::MainMenu(BinarySearchTree* courses, std::string csvPath)
             }
         }
 
+        else if (userMainInput == "4" || userMainInput == "5" || userMainInput == "6") {
+
+            // If the data structure has not been loaded yet
+            if (!treeLoaded) {
+
+                // Print message to load data structure
+                std::cout << std::endl
+                    << "Please load the data structure before attempting to edit courses."
+                    << std::endl;
+                continue;
+            }
+
+            // Declare a Course object to hold the edit and a character for the log record type
+            Course course;
+            char operation = (userMainInput == "4") ? 'A' : ((userMainInput == "5") ? 'U' : 'D');
+
+            // Prompt user for the course number and convert it to uppercase like PrintCourseInformation
+            std::cout << "Enter course number: " << std::endl;
+            std::cin >> course.courseNumber;
+            for (unsigned k = 0; k < course.courseNumber.length(); ++k) {
+
+                course.courseNumber[k] = toupper(course.courseNumber[k]);
+            }
+
+            // A comma or quote would change how the log record is split when it is read back
+            if (course.courseNumber.find_first_of(",\"") != std::string::npos) {
+
+                std::cout << std::endl << "Course numbers cannot contain commas or quotes." << std::endl;
+                continue;
+            }
+
+            // Check whether the course already exists
+            bool courseExists = !courses->Search(course.courseNumber).courseNumber.empty();
+
+            // Adding requires a new course number, updating and deleting require an existing one
+            if (operation == 'A' && courseExists) {
+
+                std::cout << std::endl << "Course Number " << course.courseNumber << " already exists." << std::endl;
+                continue;
+            }
+            else if (operation != 'A' && !courseExists) {
+
+                std::cout << std::endl << "Course Number " << course.courseNumber << " not found." << std::endl;
+                continue;
+            }
+
+            // Adds and updates also need the course name and prerequisites
+            if (operation != 'D' && !readCourseDetails(course)) {
+
+                std::cout << std::endl << "Course names and prerequisites cannot contain commas or quotes." << std::endl;
+                continue;
+            }
+
+            // Record the edit in the log and make it durable before changing the tree
+            if (!editLog.Append(operation, course) || !editLog.Commit()) {
+
+                std::cout << std::endl << "Unable to save the edit to the edit log. "
+                    << "Course " << course.courseNumber << " was not changed." << std::endl;
+                continue;
+            }
+            courses->ApplyEdit(operation, course);
+
+            // Fold the log into a new snapshot once it has grown large enough
+            editLog.CompactIfNeeded();
+
+            // Print success message
+            std::cout << std::endl << "Course " << course.courseNumber
+                << ((operation == 'A') ? " added." : ((operation == 'U') ? " updated." : " deleted."))
+                << std::endl;
+        }
+
+        else if (userMainInput == "7") {
+
+            // If the data structure has not been loaded yet
+            if (!treeLoaded) {
+
+                // Print message to load data structure
+                std::cout << std::endl
+                    << "Please load the data structure before attempting to import course edits."
+                    << std::endl;
+                continue;
+            }
+
+            // Prompt user for the file of edits
+            std::string editPath;
+            std::cout << "Enter edit file path: " << std::endl;
+            std::cin >> editPath;
+
+            // Read every edit first so a malformed file changes nothing
+            std::vector<std::pair<char, Course>> edits;
+
+            if (!WriteAheadLog::LoadEditFile(editPath, edits)) {
+
+                continue;
+            }
+
+            // Log and apply the edits, one fsync per group
+            unsigned int applied = editLog.ApplyEdits(courses, edits);
+
+            std::cout << std::endl << applied << " of " << edits.size() << " course edits imported." << std::endl;
+
+            if (applied < edits.size()) {
+
+                std::cout << "Unable to save the remaining edits to the edit log." << std::endl;
+            }
+        }
+
         else if (userMainInput == "9") {
             
             // Exit the main menu while loop
             break;
         }
     }
+
+    // Free the loaded tree now that the user is done with it
+    delete courses;
 }
 
 
@@ -321,6 +624,226 @@ Course BinarySearchTree::Search(std::string courseNumber) {
 }
 
 
+// ----------------------------------------------------------------------
+// Update
+// ------
+// Public method to replace the course stored under a courseNumber.
+//
+// @param course: the new Course object (matched by its courseNumber)
+// @return true if a course was found and replaced, otherwise false
+// ----------------------------------------------------------------------
+bool BinarySearchTree::Update(Course course) {
+
+    // Create a node pointer to keep track of the node we're currently looking at
+    Node* current = root;
+
+    // Walk down the tree the same way Search does
+    while (current != nullptr) {
+
+        if (course.courseNumber == current->course.courseNumber) {
+
+            // Replace the course stored in the node we found
+            current->course = course;
+            return true;
+        }
+        else if (course.courseNumber < current->course.courseNumber) {
+
+            current = current->left;
+        }
+        else {
+
+            current = current->right;
+        }
+    }
+
+    // The course was not in the tree
+    return false;
+}
+
+
+// ----------------------------------------------------------------------
+// Remove
+// ------
+// Public method to delete every course stored under a courseNumber.
+//
+// @param courseNumber: the courseNumber for the course to delete
+// @return true if at least one course was deleted, otherwise false
+// ----------------------------------------------------------------------
+bool BinarySearchTree::Remove(std::string courseNumber) {
+
+    bool removedAny = false;
+    bool removed = true;
+
+    // Insert allows duplicate courseNumbers, so keep removing until none are left
+    while (removed) {
+
+        removed = false;
+        root = removeNode(root, courseNumber, removed);
+        removedAny = removedAny || removed;
+    }
+
+    return removedAny;
+}
+
+
+// ------------------------------------------------------------------------------
+// removeNode
+// ----------
+// Private recursive method to remove the first node found with a courseNumber
+// from the subtree rooted at node.
+//
+// @param node: the root of the subtree we are currently reviewing
+// @param courseNumber: the courseNumber for the course to delete
+// @param removed: set to true if a node was removed
+// @return the new root of the subtree
+// ------------------------------------------------------------------------------
+Node* BinarySearchTree::removeNode(Node* node, const std::string& courseNumber, bool& removed) {
+
+    // If the subtree is empty, the course is not here
+    if (node == nullptr) {
+
+        return nullptr;
+    }
+
+    // Traverse left or right until we find the course
+    if (courseNumber < node->course.courseNumber) {
+
+        node->left = removeNode(node->left, courseNumber, removed);
+        return node;
+    }
+    else if (courseNumber > node->course.courseNumber) {
+
+        node->right = removeNode(node->right, courseNumber, removed);
+        return node;
+    }
+
+    removed = true;
+
+    // With at most one child, that child takes the place of the node we're removing
+    Node* replacement = nullptr;
+
+    if (node->left == nullptr) {
+
+        replacement = node->right;
+    }
+    else if (node->right == nullptr) {
+
+        replacement = node->left;
+    }
+
+    // With two children, the smallest node in the right subtree takes its place
+    else {
+
+        Node* rightSubtree = detachMin(node->right, replacement);
+        replacement->left = node->left;
+        replacement->right = rightSubtree;
+    }
+
+    delete node;
+    return replacement;
+}
+
+
+// ------------------------------------------------------------------------------
+// detachMin
+// ---------
+// Private recursive method to unlink the leftmost (smallest) node of a subtree.
+//
+// @param node: the root of the subtree (must not be null)
+// @param minNode: set to the node which was unlinked
+// @return the new root of the subtree
+// ------------------------------------------------------------------------------
+Node* BinarySearchTree::detachMin(Node* node, Node*& minNode) {
+
+    // If there is nothing further left, this is the smallest node
+    if (node->left == nullptr) {
+
+        minNode = node;
+        return node->right;
+    }
+
+    node->left = detachMin(node->left, minNode);
+    return node;
+}
+
+
+// ------------------------------------------------------------------------------
+// ApplyEdit
+// ---------
+// Public method to apply one edit from the menu or the write-ahead log.
+// 'A' (add) and 'U' (update) replace the course if it exists and insert it if
+// it does not, and 'D' (delete) removes it if it exists.  This makes replaying
+// a log record more than once harmless.
+//
+// @param operation: 'A', 'U' or 'D'
+// @param course: the course to add or update (only courseNumber is used for 'D')
+// ------------------------------------------------------------------------------
+void BinarySearchTree::ApplyEdit(char operation, Course course) {
+
+    if (operation == 'D') {
+
+        Remove(course.courseNumber);
+    }
+    else if (!Update(course)) {
+
+        Insert(course);
+    }
+}
+
+
+// ------------------------------------------------------------------------------
+// readCourseDetails
+// -----------------
+// Private method to prompt the user for a course name and prerequisites.
+//
+// @param course: the Course object to fill in
+// @return false if the input contains a comma or quote (which would change how
+//         the course is split when it is read back from the log)
+// ------------------------------------------------------------------------------
+bool BinarySearchTree::readCourseDetails(Course& course) {
+
+    // Discard the rest of the line left behind by the last std::cin >>
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    // Prompt user for the course name (which may contain spaces)
+    std::cout << "Enter course name: " << std::endl;
+    std::getline(std::cin, course.name);
+
+    // Prompt user for the prerequisites
+    std::string prerequisiteLine;
+    std::cout << "Enter prerequisites separated by spaces (leave blank for none): " << std::endl;
+    std::getline(std::cin, prerequisiteLine);
+
+    if (course.name.find_first_of(",\"") != std::string::npos
+        || prerequisiteLine.find_first_of(",\"") != std::string::npos) {
+
+        return false;
+    }
+
+    // Split the prerequisites on spaces and convert them to uppercase
+    std::string prerequisite;
+    prerequisiteLine += ' ';
+
+    for (unsigned k = 0; k < prerequisiteLine.length(); ++k) {
+
+        if (prerequisiteLine[k] == ' ' || prerequisiteLine[k] == '\t') {
+
+            if (!prerequisite.empty()) {
+
+                course.coursePrerequisites.push_back(prerequisite);
+                prerequisite.clear();
+            }
+        }
+        else {
+
+            prerequisite += static_cast<char>(toupper(prerequisiteLine[k]));
+        }
+    }
+
+    return true;
+}
+
+
 // --------------------------------------------------------------------------
 // PrintCourseInformation
 // ----------------------
@@ -449,36 +972,8 @@ void BinarySearchTree::LoadData(std::string csvPath, BinarySearchTree* courses)
             // For each line in the originalFile
             for (; it != originalFile.end(); it++) {
 
-                // variable to track where each line begins and ends
-                bool quoted = false;
-                // variable to track our position as we progress through the characters in each line
-                int tokenStart = 0;
-
-                // For all characters in the current line
-                for (unsigned int i = 0; i != it->length(); i++) {
-
-                    // If the character we are currently looking at is a double quote
-                    if (it->at(i) == '"') {
-
-                        // Toggle the value of the quoted variable
-                        quoted = ((quoted) ? (false) : (true));
-                    }
-
-                    // Else if the character we are currently looking at is a comma AND quoted is false
-                    else if (it->at(i) == ',' && !quoted) {
-
-                        // Create a substring beginning with the character at index of tokenStart
-                        // and ending with the character at index we are looking at minus tokenStart,
-                        // ie. create a substring from a single cell of data, then add it to the row vector
-                        row.push_back(it->substr(tokenStart, i - tokenStart));
-
-                        // Assign tokenStart with the next character so we can capture the next cell of data
-                        tokenStart = i + 1;
-                    }
-                }
-
-                // Add the last cell of data from the line into the row vector
-                row.push_back(it->substr(tokenStart, it->length() - tokenStart));
+                // Split the current line into cells of data and add them to the row vector
+                SplitLine(*it, row);
 
                 // Add the row to the 2D fileContent vector
                 fileContent.push_back(row);
@@ -514,80 +1009,348 @@ void BinarySearchTree::LoadData(std::string csvPath, BinarySearchTree* courses)
 
 
 // -----------------------------------------------------------------------------------
-// InsertCourses
-// -------------
-// Private method to take the contents of the csv file (sent from the LoadData method)
-// and create Course Objects, then send them to the Insert method in order to insert
-// them into the Binary Search Tree.
+// CourseToCsvRow
+// --------------
+// Public helper to format a course the same way it appears in the csv file:
+// courseNumber, name, then each prerequisite, separated by commas.
 //
-// @param node: the node in the tree which we are currently reviewing
-// @param course: the Course object to be added
+// @param course: the course to format
 // -----------------------------------------------------------------------------------
-void BinarySearchTree::InsertCourses(std::vector<std::vector<std::string>> fileContent, BinarySearchTree* courses) {
+std::string BinarySearchTree::CourseToCsvRow(const Course& course) {
 
-    // Variable to keep track of the rows in the fileContent vector
-    unsigned int i = 0;
-    // Variable to keep track of the cells of data in each row
-    unsigned int j = 0;
-    // Variable to keep track of any prerequisite data in each row
-    unsigned int k = 0;
+    std::string row = course.courseNumber + "," + course.name;
 
-    try {
+    for (unsigned int i = 0; i < course.coursePrerequisites.size(); ++i) {
 
-        // For each row in the fileContent vector
-        for (i; i < fileContent.size(); ++i) {
+        row += "," + course.coursePrerequisites[i];
+    }
 
-            // Vector to temporarily store prerequisites for the course to be added
-            std::vector<std::string> prerequisites;
-            // Course object to temporarily store the course data to be added
-            Course course;
+    return row;
+}
 
-            // Assign j with 0 to look at the first cell in the current row
-            j = 0;
-            // Assign courseNumber with the data in the first cell of the current row
-            course.courseNumber = fileContent[i][j];
 
-            // Assign j with 1 to look at the second cell in the current row
-            j = 1;
-            // Assign name with the data in the second cell of the current row
-            course.name = fileContent[i][j];
+// -----------------------------------------------------------------------------------
+// SplitLine
+// ---------
+// Public method to split a single line of csv data into cells of data.
+//
+// The line is processed in blocks of 64 characters.  For each block we build one
+// bitmask marking the double quotes and one marking the commas (bit i is set when
+// character i of the block matches).  A prefix-XOR of the quote mask gives us a mask
+// of every character that sits inside a quoted region, so the commas that separate
+// cells are simply the comma bits which are NOT inside a quoted region.
+//
+// The cells produced are identical to the original character-by-character loop:
+// quotes toggle the quoted state, unquoted commas end a cell, and the quote
+// characters themselves are kept in the cell.  Newlines never need a mask because
+// LoadData has already split the file into lines with getline.
+//
+// @param line: the line of csv data to split
+// @param row: the vector which the cells of data are added to
+// -----------------------------------------------------------------------------------
+void BinarySearchTree::SplitLine(const std::string& line, std::vector<std::string>& row) {
 
-            // If there are additional cells of data in the current row
-            if (fileContent.at(i).size() > 2) {
+    // Pointer to the characters of the line and the number of characters in the line
+    const char* data = line.data();
+    size_t length = line.length();
 
-                // For any additional cells of data
-                for (k = 2; k < fileContent.at(i).size(); ++k) {
+    // Variable to track our position as we progress through the cells in the line
+    size_t tokenStart = 0;
+    // All ones if the previous block ended inside a quoted region, otherwise all zeros
+    uint64_t quotedCarry = 0;
+    // Zero padded buffer used for the final partial block of the line
+    char tail[64];
 
-                    // Add the cell of data to the temporary prerequisites vector
-                    prerequisites.push_back(fileContent[i][k]);
-                }
-            }
+    // For each block of 64 characters in the line
+    for (size_t blockStart = 0; blockStart < length; blockStart += 64) {
 
-            // Assign coursePrerequisites with the 
-            course.coursePrerequisites = prerequisites;
+        // Pointer to the block we are currently looking at
+        const char* block = data + blockStart;
 
-            // Insert the new course into the courses binary search tree
-            courses->Insert(course);
+        // If there are fewer than 64 characters left, copy them into the zero padded buffer
+        if (length - blockStart < 64) {
+
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, block, length - blockStart);
+            block = tail;
         }
-    }
 
-    // Catch standard runtime errors
-    catch (std::runtime_error& error) {
-        std::cerr << error.what() << std::endl;
-    }
-}
+        // Build the quote and comma bitmasks for the block
+        uint64_t quoteMask = 0;
+        uint64_t commaMask = 0;
 
+        if (simdMasks) {
 
-// -------------------------------------------------------------
-// Insert
-// ------
-// Public method to insert a course into the Binary Search Tree.
-//
-// In this implementation of the program, Insert is only called
-// from the InsertCourses method which is called from the
-// LoadData method.
-//
-// @param course: the Course object we're trying to insert
+            buildBlockMasksSse2(block, quoteMask, commaMask);
+        }
+        else {
+
+            buildBlockMasksScalar(block, quoteMask, commaMask);
+        }
+
+        // Mark every character inside a quoted region, continuing any region left open by the previous block
+        uint64_t quotedMask = prefixXor(quoteMask) ^ quotedCarry;
+        // Carry the quoted state of the last character into the next block
+        quotedCarry = (quotedMask >> 63) ? ~uint64_t(0) : 0;
+
+        // Only the commas outside of quoted regions separate cells
+        uint64_t separatorMask = commaMask & ~quotedMask;
+
+        // For each separator in the block
+        while (separatorMask != 0) {
+
+            // Position of the separator within the line
+            size_t i = blockStart + lowestSetBit(separatorMask);
+
+            // Add the cell of data ending just before the separator to the row vector
+            row.push_back(line.substr(tokenStart, i - tokenStart));
+
+            // Assign tokenStart with the next character so we can capture the next cell of data
+            tokenStart = i + 1;
+
+            // Clear the separator we just handled
+            separatorMask &= separatorMask - 1;
+        }
+    }
+
+    // Add the last cell of data from the line into the row vector
+    row.push_back(line.substr(tokenStart, length - tokenStart));
+}
+
+
+// SSE2 masks are used by default wherever they were compiled in
+#ifdef COURSE_PLANNER_SSE2
+bool BinarySearchTree::simdMasks = true;
+#else
+bool BinarySearchTree::simdMasks = false;
+#endif
+
+
+// -----------------------------------------------------------------------------------
+// SetSimdMasks
+// ------------
+// Public method to choose between the SSE2 and scalar mask builders at runtime.
+//
+// @param enabled: true to use SSE2, false to use the scalar mask builder
+// @return true if SSE2 is now in use (always false on builds without SSE2)
+// -----------------------------------------------------------------------------------
+bool BinarySearchTree::SetSimdMasks(bool enabled) {
+
+#ifdef COURSE_PLANNER_SSE2
+    simdMasks = enabled;
+#else
+    simdMasks = false;
+    (void)enabled;
+#endif
+
+    return simdMasks;
+}
+
+
+// -----------------------------------------------------------------------------------
+// buildBlockMasksScalar
+// ---------------------
+// Private helper to build the quote and comma bitmasks for a block of 64 characters
+// by checking each character in turn.
+//
+// @param block: pointer to the 64 characters to look at
+// @param quoteMask: set with a bit for every double quote in the block
+// @param commaMask: set with a bit for every comma in the block
+// -----------------------------------------------------------------------------------
+void BinarySearchTree::buildBlockMasksScalar(const char* block, uint64_t& quoteMask, uint64_t& commaMask) {
+
+    // For each character in the block
+    for (unsigned i = 0; i < 64; ++i) {
+
+        quoteMask |= uint64_t(block[i] == '"') << i;
+        commaMask |= uint64_t(block[i] == ',') << i;
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+// buildBlockMasksSse2
+// -------------------
+// Private helper to build the same bitmasks as buildBlockMasksScalar, comparing 16
+// characters at a time with SSE2.  Falls back to the scalar builder on builds
+// without SSE2.
+//
+// @param block: pointer to the 64 characters to look at
+// @param quoteMask: set with a bit for every double quote in the block
+// @param commaMask: set with a bit for every comma in the block
+// -----------------------------------------------------------------------------------
+void BinarySearchTree::buildBlockMasksSse2(const char* block, uint64_t& quoteMask, uint64_t& commaMask) {
+
+#ifdef COURSE_PLANNER_SSE2
+
+    const __m128i quotes = _mm_set1_epi8('"');
+    const __m128i commas = _mm_set1_epi8(',');
+
+    // For each group of 16 characters in the block
+    for (unsigned lane = 0; lane < 4; ++lane) {
+
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + lane * 16));
+
+        // movemask gives us one bit per character that matched the comparison
+        uint64_t quoteBits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quotes)));
+        uint64_t commaBits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, commas)));
+
+        quoteMask |= quoteBits << (lane * 16);
+        commaMask |= commaBits << (lane * 16);
+    }
+
+#else
+
+    buildBlockMasksScalar(block, quoteMask, commaMask);
+
+#endif
+}
+
+
+// -----------------------------------------------------------------------------------
+// prefixXor
+// ---------
+// Private helper which sets each bit to the XOR of itself and every lower bit.
+// Applied to a quote mask this sets every bit from an opening quote up to (but not
+// including) the matching closing quote.
+//
+// @param mask: the bitmask to scan
+// -----------------------------------------------------------------------------------
+uint64_t BinarySearchTree::prefixXor(uint64_t mask) {
+
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+
+    return mask;
+}
+
+
+// -----------------------------------------------------------------------------------
+// lowestSetBit
+// ------------
+// Private helper to return the index of the lowest set bit in a non-zero mask.
+//
+// @param mask: the bitmask to look at (must not be zero)
+// -----------------------------------------------------------------------------------
+unsigned BinarySearchTree::lowestSetBit(uint64_t mask) {
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask))) {
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+
+// -----------------------------------------------------------------------------------
+// InsertCourses
+// -------------
+// Private method to take the contents of the csv file (sent from the LoadData method)
+// and create Course Objects.  If the tree is empty the courses are handed to BulkBuild
+// all at once, otherwise each one is sent to the Insert method.
+//
+// @param fileContent: the rows of csv data, one vector of cells per row
+// @param courses: the pointer for the BinarySearchTree which will hold course objects
+// -----------------------------------------------------------------------------------
+void BinarySearchTree::InsertCourses(std::vector<std::vector<std::string>> fileContent, BinarySearchTree* courses) {
+
+    // Variable to keep track of the rows in the fileContent vector
+    unsigned int i = 0;
+    // Variable to keep track of the cells of data in each row
+    unsigned int j = 0;
+    // Variable to keep track of any prerequisite data in each row
+    unsigned int k = 0;
+
+    // Vector to collect the Course objects created from each row
+    std::vector<Course> courseList;
+    courseList.reserve(fileContent.size());
+
+    try {
+
+        // For each row in the fileContent vector
+        for (i; i < fileContent.size(); ++i) {
+
+            // Vector to temporarily store prerequisites for the course to be added
+            std::vector<std::string> prerequisites;
+            // Course object to temporarily store the course data to be added
+            Course course;
+
+            // Assign j with 0 to look at the first cell in the current row
+            j = 0;
+            // Assign courseNumber with the data in the first cell of the current row
+            course.courseNumber = fileContent[i][j];
+
+            // Assign j with 1 to look at the second cell in the current row
+            j = 1;
+            // Assign name with the data in the second cell of the current row
+            course.name = fileContent[i][j];
+
+            // If there are additional cells of data in the current row
+            if (fileContent.at(i).size() > 2) {
+
+                // For any additional cells of data
+                for (k = 2; k < fileContent.at(i).size(); ++k) {
+
+                    // Add the cell of data to the temporary prerequisites vector
+                    prerequisites.push_back(fileContent[i][k]);
+                }
+            }
+
+            // Assign coursePrerequisites with the 
+            course.coursePrerequisites = prerequisites;
+
+            // Add the new course to the list of courses to be inserted
+            courseList.push_back(course);
+        }
+
+        // If the tree is empty, build the whole tree from the course list in one pass
+        if (courses->root == nullptr) {
+
+            courses->BulkBuild(courseList);
+        }
+
+        // Otherwise insert the courses one at a time into the existing tree
+        else {
+
+            for (i = 0; i < courseList.size(); ++i) {
+
+                courses->Insert(courseList[i]);
+            }
+        }
+    }
+
+    // Catch standard runtime errors
+    catch (std::runtime_error& error) {
+        std::cerr << error.what() << std::endl;
+    }
+}
+
+
+// -------------------------------------------------------------
+// Insert
+// ------
+// Public method to insert a course into the Binary Search Tree.
+//
+// Insert is called from InsertCourses and BulkBuild when the
+// tree already holds courses (an empty tree is filled by
+// BulkBuild's balanced build instead), and from ApplyEdit when
+// a course is added or updated from the menu, from an imported
+// edit file, or while Recover replays the edit log.
+//
+// @param course: the Course object we're trying to insert
 // -------------------------------------------------------------
 void BinarySearchTree::Insert(Course course) {
 
@@ -607,6 +1370,99 @@ void BinarySearchTree::Insert(Course course) {
 }
 
 
+// ------------------------------------------------------------------------------------
+// BulkBuild
+// ---------
+// Public method to fill an empty Binary Search Tree with a whole list of courses.
+//
+// Inserting n courses one at a time costs O(n log n) on average, and O(n^2) when the
+// courses arrive already sorted because every new node lands at the end of one long
+// right-hand chain.  Instead we sort the list once (skipping the sort entirely if the
+// list is already in order) and then build a perfectly balanced tree from the sorted
+// list in O(n), so every Search afterwards takes at most log2(n) + 1 comparisons.
+//
+// Courses with the same courseNumber keep their original order, and the first of
+// them is always the one closest to the root, just as it would be with Insert.
+//
+// @param courseList: the Course objects to add (sorted in place by courseNumber)
+// ------------------------------------------------------------------------------------
+void BinarySearchTree::BulkBuild(std::vector<Course>& courseList) {
+
+    // If the tree already has courses, fall back to inserting them one at a time
+    if (root != nullptr) {
+
+        for (unsigned int i = 0; i < courseList.size(); ++i) {
+
+            Insert(courseList[i]);
+        }
+        return;
+    }
+
+    // Only sort if the list is not already in alphanumeric order
+    if (!std::is_sorted(courseList.begin(), courseList.end(), courseLess)) {
+
+        // stable_sort keeps courses with the same courseNumber in their original order
+        std::stable_sort(courseList.begin(), courseList.end(), courseLess);
+    }
+
+    // Build the tree from the full range of sorted courses
+    root = buildBalanced(courseList, 0, courseList.size());
+}
+
+
+// ------------------------------------------------------------------------------------
+// buildBalanced
+// -------------
+// Private recursive method to build a balanced subtree from a range of sorted courses.
+// The middle course becomes the root of the subtree, the courses before it become the
+// left subtree and the courses after it become the right subtree.  Each course is
+// visited exactly once, so building the whole tree is O(n).
+//
+// @param sortedCourses: the courses, sorted by courseNumber
+// @param first: index of the first course in the range
+// @param last: index one past the last course in the range
+// ------------------------------------------------------------------------------------
+Node* BinarySearchTree::buildBalanced(std::vector<Course>& sortedCourses, size_t first, size_t last) {
+
+    // If the range is empty, there is no subtree to build
+    if (first >= last) {
+
+        return nullptr;
+    }
+
+    // Pick the middle course of the range
+    size_t middle = first + (last - first) / 2;
+
+    // Move back to the first course with the same courseNumber so the left subtree
+    // only holds smaller courseNumbers (addNode sends equal courseNumbers right)
+    while (middle > first && sortedCourses[middle - 1].courseNumber == sortedCourses[middle].courseNumber) {
+
+        --middle;
+    }
+
+    // Create the node for the middle course and build its subtrees from either side of it
+    Node* node = new Node(sortedCourses[middle]);
+    node->left = buildBalanced(sortedCourses, first, middle);
+    node->right = buildBalanced(sortedCourses, middle + 1, last);
+
+    return node;
+}
+
+
+// ------------------------------------------------------------------------------------
+// courseLess
+// ----------
+// Private helper used to sort courses in alphanumeric order by courseNumber.
+//
+// @param a: the first course to compare
+// @param b: the second course to compare
+// ------------------------------------------------------------------------------------
+bool BinarySearchTree::courseLess(const Course& a, const Course& b) {
+
+    return a.courseNumber < b.courseNumber;
+}
+
+
 // ------------------------------------------------------------------------------
 // addNode
 // -------
@@ -723,16 +1579,2073 @@ void BinarySearchTree::inOrder(Node* node) {
 };
 
 
+// --------------------------------------------------------------------------------------
+// CollectCourses
+// --------------
+// Public method to copy every course in the tree into a vector in alphanumeric order
+//
+// @param courseList: the vector which the courses are added to
+// --------------------------------------------------------------------------------------
+void BinarySearchTree::CollectCourses(std::vector<Course>& courseList) {
+
+    // Call the private collectInOrder method and send the root node as the starting point
+    this->collectInOrder(root, courseList);
+}
+
+
+// ----------------------------------------------------------------------------
+// collectInOrder
+// --------------
+// Private recursive method to traverse a binary search tree from left to right
+// and add the course stored in each node to a vector.
+//
+// @param node: the node in the tree which we are currently reviewing
+// @param courseList: the vector which the courses are added to
+// ----------------------------------------------------------------------------
+void BinarySearchTree::collectInOrder(Node* node, std::vector<Course>& courseList) {
+
+    // If the node we're starting from is null, there's nothing to traverse
+    if (node == nullptr) {
+
+        return;
+    }
+
+    // Collect the left subtree, then this node, then the right subtree
+    collectInOrder(node->left, courseList);
+    courseList.push_back(node->course);
+    collectInOrder(node->right, courseList);
+}
+
+
+// --------------------------------------------------------------------------------------
+// Height
+// ------
+// Public method to get the number of nodes on the longest path from the root to a leaf
+// (0 for an empty tree), which is the most comparisons a Search can take.
+// --------------------------------------------------------------------------------------
+unsigned int BinarySearchTree::Height() {
+
+    // Call the private height method and send the root node as the starting point
+    return this->height(root);
+}
+
+
+// ----------------------------------------------------------------------------
+// height
+// ------
+// Private recursive method to get the height of the subtree below a node.
+//
+// @param node: the node in the tree which we are currently reviewing
+// ----------------------------------------------------------------------------
+unsigned int BinarySearchTree::height(Node* node) {
+
+    // An empty subtree has no height
+    if (node == nullptr) {
+
+        return 0;
+    }
+
+    // This node plus the taller of its two subtrees
+    return 1 + std::max(height(node->left), height(node->right));
+}
+
+
+// Constructor for WriteAheadLog class
+// -----------------------------------
+// The log and snapshot files live next to the csv file.
+//
+// @param csvPath: the file path for the csv input file
+// @param groupSize: the largest number of edits ApplyEdits commits with one fsync
+// @param compactThreshold: the number of logged records which triggers compaction
+// -----------------------------------
+WriteAheadLog::WriteAheadLog(std::string csvPath, unsigned int groupSize, unsigned int compactThreshold) {
+
+    this->logPath = csvPath + ".wal";
+    this->snapshotPath = csvPath + ".snapshot";
+    this->tempSnapshotPath = csvPath + ".snapshot.tmp";
+    this->oldSnapshotPath = csvPath + ".snapshot.old";
+    this->logFile = nullptr;
+    this->committedSize = 0;
+    this->pendingRecords = 0;
+    this->loggedRecords = 0;
+    this->groupSize = (groupSize == 0) ? 1 : groupSize;
+    this->compactThreshold = compactThreshold;
+}
+
+
+// Destructor
+// ----------
+// Commits any pending records and closes the log file.
+WriteAheadLog::~WriteAheadLog() {
+
+    if (logFile != nullptr) {
+
+        // Commit closes the log itself if it fails
+        if (Commit()) {
+
+            std::fclose(logFile);
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+// Recover
+// -------
+// Public method to load the catalog and bring it up to date with the edits.
+//
+// Loads the csv file, replays the snapshot of earlier edits on top of it, then replays
+// the log.  If compaction was interrupted after the old snapshot was moved aside but
+// before the new one took its place, the old snapshot is replayed instead (the log
+// has not been emptied yet, so nothing is lost).  The log is then opened so new
+// records can be appended, after cutting off any record at its end which was only
+// partly written.  If that fails, edits are refused until the next Recover.
+//
+// @param courses: the pointer for the (empty) BinarySearchTree to load into
+// @param csvPath: the file path for the csv input file
+// -----------------------------------------------------------------------------------
+void WriteAheadLog::Recover(BinarySearchTree* courses, std::string csvPath) {
+
+    // Close the log if we are reloading
+    if (logFile != nullptr) {
+
+        if (Commit()) {
+
+            std::fclose(logFile);
+        }
+        logFile = nullptr;
+    }
+
+    netEdits.clear();
+
+    // The csv file is always the base of the catalog
+    courses->LoadData(csvPath, courses);
+
+    // Apply the snapshot and the log on top of it
+    long completeSize = 0;
+    bool tornRecord = false;
+    loggedRecords = replayEdits(courses, completeSize, tornRecord);
+
+    // Open the log so new records are added to the end of it
+    if (!openLog("ab")) {
+
+        return;
+    }
+
+    // A cut off record would run into the next record we append, so cut it off the
+    // end of the log first.  If we can't, the log is closed and edits are refused.
+    if (tornRecord && (!truncateLog(completeSize) || !syncFile(logFile))) {
+
+        std::cerr << "Unable to remove a partly written record from edit log: " << logPath << std::endl;
+        std::fclose(logFile);
+        logFile = nullptr;
+        return;
+    }
+
+    CompactIfNeeded();
+}
+
+
+// -----------------------------------------------------------------------------------
+// LoadWithEdits
+// -------------
+// Public method to load a catalog with every saved edit applied, for callers which
+// only read the catalog (such as CatalogRegistry).  The csv file, snapshot and log
+// are loaded the same way as Recover, but nothing is written: the log is never
+// opened for appending, and a record cut off at the end of it is simply skipped.
+//
+// @param courses: the pointer for the (empty) BinarySearchTree to load into
+// @param csvPath: the file path for the csv input file
+// -----------------------------------------------------------------------------------
+void WriteAheadLog::LoadWithEdits(BinarySearchTree* courses, std::string csvPath) {
+
+    WriteAheadLog editLog(csvPath);
+
+    courses->LoadData(csvPath, courses);
+
+    long completeSize = 0;
+    bool tornRecord = false;
+    editLog.replayEdits(courses, completeSize, tornRecord);
+}
+
+
+// -----------------------------------------------------------------------------------
+// replayEdits
+// -----------
+// Private method to apply the snapshot, then the log, to a tree which already holds
+// the csv file.  If compaction was interrupted after the old snapshot was moved aside
+// but before the new one took its place, the old snapshot is replayed instead.
+//
+// @param courses: the pointer for the BinarySearchTree to apply the edits to
+// @param completeSize: set to the size of the log up to the end of its last complete record
+// @param tornRecord: set to true if the log ends with a record which was cut off
+// @return the number of records replayed from the log
+// -----------------------------------------------------------------------------------
+unsigned int WriteAheadLog::replayEdits(BinarySearchTree* courses, long& completeSize, bool& tornRecord) {
+
+    // Apply the net edits from before the last compaction
+    if (fileExists(snapshotPath)) {
+
+        replayFile(snapshotPath, courses, completeSize, tornRecord);
+    }
+    else if (fileExists(oldSnapshotPath)) {
+
+        replayFile(oldSnapshotPath, courses, completeSize, tornRecord);
+    }
+
+    // Apply every edit made since the last compaction
+    return replayFile(logPath, courses, completeSize, tornRecord);
+}
+
+
+// -----------------------------------------------------------------------------------
+// replayFile
+// ----------
+// Private method to apply every complete record in a log or snapshot file to the
+// tree, and add it to the net edits.
+//
+// A final line without a newline was cut off part way through being written, so it
+// is ignored.
+//
+// @param path: the file path for the log or snapshot file
+// @param courses: the pointer for the BinarySearchTree to apply the records to
+// @param completeSize: set to the size of the file up to the end of its last complete record
+// @param tornRecord: set to true if the file ends with a record which was cut off
+// @return the number of records applied
+// -----------------------------------------------------------------------------------
+unsigned int WriteAheadLog::replayFile(const std::string& path, BinarySearchTree* courses, long& completeSize,
+    bool& tornRecord) {
+
+    completeSize = 0;
+    tornRecord = false;
+
+    // Read the whole file (it is fine for it not to exist yet)
+    std::ifstream inputFile(path.c_str(), std::ios::binary);
+    if (!inputFile.is_open()) {
+
+        return 0;
+    }
+
+    std::string fileData((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+    inputFile.close();
+
+    // Variable to track the number of records applied
+    unsigned int recordCount = 0;
+    // Variable to track where the current record begins
+    size_t recordStart = 0;
+
+    // For each complete (newline terminated) record in the file
+    for (size_t recordEnd = fileData.find('\n'); recordEnd != std::string::npos;
+         recordEnd = fileData.find('\n', recordStart)) {
+
+        std::string record = fileData.substr(recordStart, recordEnd - recordStart);
+        recordStart = recordEnd + 1;
+
+        char operation;
+        Course course;
+
+        if (!ParseRecord(record, operation, course)) {
+
+            std::cerr << "Skipping malformed edit log record: " << record << std::endl;
+            continue;
+        }
+
+        courses->ApplyEdit(operation, course);
+        recordEdit(operation, course);
+        ++recordCount;
+    }
+
+    // Anything after the last newline is a record which was cut off
+    completeSize = static_cast<long>(recordStart);
+    tornRecord = (recordStart < fileData.length());
+
+    return recordCount;
+}
+
+
+// -----------------------------------------------------------------------------------
+// ParseRecord
+// -----------
+// Public helper to read one edit record: the operation ('A', 'U' or 'D') followed by
+// the course in the same comma separated layout as the csv file.
+//
+// @param record: the record, without its newline
+// @param operation: set to the operation
+// @param course: set to the course (only courseNumber for 'D')
+// @return false if the record is malformed
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::ParseRecord(const std::string& record, char& operation, Course& course) {
+
+    std::vector<std::string> row;
+    BinarySearchTree::SplitLine(record, row);
+
+    // A record needs an operation and a course number, and adds/updates also need a name
+    if (row.size() < 2 || row[0].length() != 1 || row[1].empty()
+        || (row[0][0] != 'A' && row[0][0] != 'U' && row[0][0] != 'D')
+        || (row[0][0] != 'D' && row.size() < 3)) {
+
+        return false;
+    }
+
+    // Rebuild the course from the cells of the record
+    operation = row[0][0];
+    course = Course();
+    course.courseNumber = row[1];
+
+    if (row.size() > 2) {
+
+        course.name = row[2];
+        course.coursePrerequisites.assign(row.begin() + 3, row.end());
+    }
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// formatRecord
+// ------------
+// Private helper to build the log line for an edit (the inverse of ParseRecord).
+//
+// @param operation: 'A', 'U' or 'D'
+// @param course: the course being edited (only courseNumber is written for 'D')
+// -----------------------------------------------------------------------------------
+std::string WriteAheadLog::formatRecord(char operation, const Course& course) {
+
+    std::string record(1, operation);
+    record += ",";
+    record += (operation == 'D') ? course.courseNumber : BinarySearchTree::CourseToCsvRow(course);
+    record += "\n";
+
+    return record;
+}
+
+
+// -----------------------------------------------------------------------------------
+// recordEdit
+// ----------
+// Private method to fold one edit into the net edits for its course number.
+//
+// @param operation: 'A', 'U' or 'D'
+// @param course: the course being edited
+// -----------------------------------------------------------------------------------
+void WriteAheadLog::recordEdit(char operation, const Course& course) {
+
+    NetEdit& edit = netEdits[course.courseNumber];
+
+    if (operation == 'D') {
+
+        // A delete removes every earlier add or update (and any duplicates from the csv file)
+        edit.deleted = true;
+        edit.present = false;
+        edit.course = Course();
+    }
+    else {
+
+        edit.present = true;
+        edit.course = course;
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+// Append
+// ------
+// Public method to add an edit record to the log.  The record is not guaranteed to
+// survive a power failure until the next Commit, and must not be applied to the
+// tree before then.
+//
+// If the record cannot be written, every record since the last commit is rolled
+// back and the log refuses further edits until the catalog is reloaded.
+//
+// @param operation: 'A' (add), 'U' (update) or 'D' (delete)
+// @param course: the course being edited (only courseNumber is written for 'D')
+// @return false if the record could not be written
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::Append(char operation, const Course& course) {
+
+    if (logFile == nullptr) {
+
+        return false;
+    }
+
+    // Build the record: the operation followed by the course in csv layout
+    std::string record = formatRecord(operation, course);
+
+    if (std::fwrite(record.data(), 1, record.length(), logFile) != record.length()) {
+
+        rollBack();
+        return false;
+    }
+
+    pendingEdits.push_back(std::make_pair(operation, course));
+    ++pendingRecords;
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Commit
+// ------
+// Public method to make every pending record durable with a single fsync.
+//
+// If the fsync fails, the pending records are rolled back and the log refuses
+// further edits until the catalog is reloaded.
+//
+// @return true if every record appended so far is durable
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::Commit() {
+
+    if (logFile == nullptr) {
+
+        return pendingRecords == 0;
+    }
+
+    if (pendingRecords == 0) {
+
+        return true;
+    }
+
+    if (!syncFile(logFile)) {
+
+        rollBack();
+        return false;
+    }
+
+    // The pending edits are durable now, so add them to the net edits
+    for (size_t i = 0; i < pendingEdits.size(); ++i) {
+
+        recordEdit(pendingEdits[i].first, pendingEdits[i].second);
+    }
+
+    loggedRecords += pendingRecords;
+    pendingRecords = 0;
+    pendingEdits.clear();
+    committedSize = std::ftell(logFile);
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// ApplyEdits
+// ----------
+// Public method to log and apply a batch of edits with group commit.
+//
+// The edits are appended in groups of up to groupSize, each group is made durable
+// with a single Commit, and only then are that group's edits applied to the tree.
+// If a group cannot be committed it is rolled back and the remaining edits are not
+// applied.
+//
+// @param courses: the pointer for the BinarySearchTree to apply the edits to
+// @param edits: the operation ('A', 'U' or 'D') and course for each edit
+// @return the number of edits which were logged and applied
+// -----------------------------------------------------------------------------------
+unsigned int WriteAheadLog::ApplyEdits(BinarySearchTree* courses, const std::vector<std::pair<char, Course>>& edits) {
+
+    // Make sure nothing from an earlier caller is mixed into the first group
+    if (!Commit()) {
+
+        return 0;
+    }
+
+    unsigned int applied = 0;
+
+    // For each group of edits
+    for (size_t groupStart = 0; groupStart < edits.size(); groupStart += groupSize) {
+
+        size_t groupEnd = std::min(edits.size(), groupStart + groupSize);
+
+        // Append the whole group, then make it durable with one fsync
+        for (size_t i = groupStart; i < groupEnd; ++i) {
+
+            if (!Append(edits[i].first, edits[i].second)) {
+
+                return applied;
+            }
+        }
+
+        if (!Commit()) {
+
+            return applied;
+        }
+
+        // The group is durable, so apply it to the tree
+        for (size_t i = groupStart; i < groupEnd; ++i) {
+
+            courses->ApplyEdit(edits[i].first, edits[i].second);
+            ++applied;
+        }
+
+        CompactIfNeeded();
+    }
+
+    return applied;
+}
+
+
+// -----------------------------------------------------------------------------------
+// LoadEditFile
+// ------------
+// Public helper to read a file of edits, one per line in the same layout as the log
+// ('A', 'U' or 'D', then the course in csv layout).  Blank lines are skipped and
+// course numbers are converted to uppercase like the menu does.
+//
+// @param editPath: the file path for the file of edits
+// @param edits: set to the edits read from the file
+// @return false (after printing why) if the file could not be read or a line is malformed
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::LoadEditFile(std::string editPath, std::vector<std::pair<char, Course>>& edits) {
+
+    std::ifstream editFile(editPath.c_str());
+
+    if (!editFile.is_open()) {
+
+        std::cout << std::endl << "Unable to open file: " << editPath << std::endl;
+        return false;
+    }
+
+    edits.clear();
+
+    std::string line;
+    unsigned int lineNumber = 0;
+
+    while (std::getline(editFile, line)) {
+
+        ++lineNumber;
+
+        // Files saved on Windows leave a carriage return at the end of each line
+        if (!line.empty() && line[line.length() - 1] == '\r') {
+
+            line.erase(line.length() - 1);
+        }
+        if (line.empty()) {
+
+            continue;
+        }
+
+        char operation;
+        Course course;
+
+        if (!ParseRecord(line, operation, course)) {
+
+            std::cout << std::endl << "Malformed edit on line " << lineNumber << " of " << editPath << std::endl;
+            return false;
+        }
+
+        // Convert the course number and prerequisites to uppercase
+        for (unsigned k = 0; k < course.courseNumber.length(); ++k) {
+
+            course.courseNumber[k] = toupper(course.courseNumber[k]);
+        }
+        for (unsigned i = 0; i < course.coursePrerequisites.size(); ++i) {
+
+            for (unsigned k = 0; k < course.coursePrerequisites[i].length(); ++k) {
+
+                course.coursePrerequisites[i][k] = toupper(course.coursePrerequisites[i][k]);
+            }
+        }
+
+        edits.push_back(std::make_pair(operation, course));
+    }
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// openLog
+// -------
+// Private method to open the log file.  The file is unbuffered, so every record is
+// handed to the operating system as soon as it is appended and a failed write is
+// reported straight away.
+//
+// @param mode: "ab" to append to the log, "wb" to empty it
+// @return false if the log could not be opened
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::openLog(const char* mode) {
+
+    logFile = std::fopen(logPath.c_str(), mode);
+
+    if (logFile == nullptr) {
+
+        std::cout << std::endl << "Unable to open edit log: " << logPath << std::endl;
+        return false;
+    }
+
+    std::setvbuf(logFile, nullptr, _IONBF, 0);
+    std::fseek(logFile, 0, SEEK_END);
+    committedSize = std::ftell(logFile);
+
+    // If the log was just created, make sure its directory entry is on disk too
+    if (!syncDirectory(logPath)) {
+
+        std::cerr << "Unable to sync edit log directory for: " << logPath << std::endl;
+    }
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// rollBack
+// --------
+// Private method to cut every record since the last commit off the end of the log
+// and close it.  Nothing appended since the last commit has been applied to the
+// tree, so the catalog and the log agree again.  Further edits are refused until
+// Recover reopens the log.
+// -----------------------------------------------------------------------------------
+void WriteAheadLog::rollBack() {
+
+    std::cerr << "Unable to write edit log: " << logPath << std::endl;
+
+    if (!truncateLog(committedSize)) {
+
+        std::cerr << "Unable to roll back edit log: " << logPath << std::endl;
+    }
+
+    std::fclose(logFile);
+    logFile = nullptr;
+    pendingRecords = 0;
+    pendingEdits.clear();
+}
+
+
+// -----------------------------------------------------------------------------------
+// truncateLog
+// -----------
+// Private method to cut the open log file down to a given size.  The next record
+// appended starts at that size, which becomes the committed size.
+//
+// @param size: the size to cut the log down to
+// @return false if the log could not be truncated
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::truncateLog(long size) {
+
+#if defined(_MSC_VER)
+    bool truncated = (_chsize_s(_fileno(logFile), size) == 0);
+#else
+    bool truncated = (ftruncate(fileno(logFile), size) == 0);
+#endif
+
+    if (truncated) {
+
+        std::fseek(logFile, 0, SEEK_END);
+        committedSize = size;
+    }
+
+    return truncated;
+}
+
+
+// -----------------------------------------------------------------------------------
+// CompactIfNeeded
+// ---------------
+// Public method to compact the log once it holds compactThreshold records.
+// -----------------------------------------------------------------------------------
+void WriteAheadLog::CompactIfNeeded() {
+
+    if (compactThreshold != 0 && loggedRecords >= compactThreshold) {
+
+        Compact();
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+// Compact
+// -------
+// Public method to write the net edits to a new snapshot and empty the log.
+//
+// For each edited course the snapshot holds a delete (if the course was ever deleted)
+// followed by an update (if it still exists), which replays to the same catalog as
+// the full history of edits.  The new snapshot is written and synced under a
+// temporary name first.  The old snapshot is then moved aside, the new one is moved
+// into place, and only after that is the log emptied.  Recover can rebuild the
+// catalog after a crash at any point in between.
+// -----------------------------------------------------------------------------------
+void WriteAheadLog::Compact() {
+
+    if (logFile == nullptr) {
+
+        return;
+    }
+
+    // Make sure everything in the log is on disk before we start
+    if (!Commit()) {
+
+        return;
+    }
+
+    // Write the new snapshot under its temporary name
+    FILE* snapshotFile = std::fopen(tempSnapshotPath.c_str(), "wb");
+    if (snapshotFile == nullptr) {
+
+        std::cerr << "Unable to write snapshot: " << tempSnapshotPath << std::endl;
+        return;
+    }
+
+    std::map<std::string, NetEdit>::const_iterator it = netEdits.begin();
+    bool written = true;
+
+    for (; it != netEdits.end() && written; ++it) {
+
+        std::string records;
+
+        if (it->second.deleted) {
+
+            Course deletedCourse;
+            deletedCourse.courseNumber = it->first;
+            records += formatRecord('D', deletedCourse);
+        }
+        if (it->second.present) {
+
+            records += formatRecord('U', it->second.course);
+        }
+
+        written = (std::fwrite(records.data(), 1, records.length(), snapshotFile) == records.length());
+    }
+
+    // A short write must never be moved into place, since the log is emptied afterwards
+    bool synced = written && !std::ferror(snapshotFile) && syncFile(snapshotFile);
+    std::fclose(snapshotFile);
+
+    if (!synced) {
+
+        std::cerr << "Unable to write snapshot: " << tempSnapshotPath << std::endl;
+        std::remove(tempSnapshotPath.c_str());
+        return;
+    }
+
+    // Move the old snapshot aside, then move the new one into place
+    // (std::rename will not replace an existing file on every platform)
+    std::remove(oldSnapshotPath.c_str());
+    if (fileExists(snapshotPath) && std::rename(snapshotPath.c_str(), oldSnapshotPath.c_str()) != 0) {
+
+        std::cerr << "Unable to replace snapshot: " << snapshotPath << std::endl;
+        return;
+    }
+    if (std::rename(tempSnapshotPath.c_str(), snapshotPath.c_str()) != 0) {
+
+        std::cerr << "Unable to replace snapshot: " << snapshotPath << std::endl;
+        return;
+    }
+
+    // The rename must reach the disk before the log is emptied, otherwise a power
+    // failure could keep the empty log but lose the new snapshot
+    if (!syncDirectory(snapshotPath)) {
+
+        std::cerr << "Unable to sync snapshot directory for: " << snapshotPath << std::endl;
+        return;
+    }
+    std::remove(oldSnapshotPath.c_str());
+
+    // Every logged edit is now in the snapshot, so empty the log
+    std::fclose(logFile);
+    logFile = nullptr;
+
+    if (!openLog("wb")) {
+
+        return;
+    }
+    syncFile(logFile);
+
+    loggedRecords = 0;
+}
+
+
+// -----------------------------------------------------------------------------------
+// syncFile
+// --------
+// Private helper to flush a file's buffers and ask the operating system to write
+// its contents to disk.
+//
+// @param file: the open file to sync
+// @return true if the file was synced
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::syncFile(FILE* file) {
+
+    if (std::fflush(file) != 0) {
+
+        return false;
+    }
+
+#if defined(_MSC_VER)
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+
+// -----------------------------------------------------------------------------------
+// syncDirectory
+// -------------
+// Private helper to make renames and newly created files in a file's directory
+// durable.  On POSIX systems a rename is only on disk once the directory itself has
+// been fsynced.  Windows has no equivalent call (NTFS journals renames itself), so
+// there this does nothing.
+//
+// @param path: the path of a file in the directory to sync
+// @return true if the directory was synced
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::syncDirectory(const std::string& path) {
+
+#if defined(_MSC_VER)
+    (void)path;
+    return true;
+#else
+    // The directory is everything before the last slash, or the current directory
+    size_t slash = path.find_last_of('/');
+    std::string directory = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+
+    int descriptor = open(directory.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+
+        return false;
+    }
+
+    bool synced = (fsync(descriptor) == 0);
+    close(descriptor);
+
+    return synced;
+#endif
+}
+
+
+// -----------------------------------------------------------------------------------
+// fileExists
+// ----------
+// Private helper to check whether a file can be opened for reading.
+//
+// @param path: the file path to check
+// -----------------------------------------------------------------------------------
+bool WriteAheadLog::fileExists(const std::string& path) {
+
+    std::ifstream file(path.c_str());
+    return file.is_open();
+}
+
+
+// ----------------------------------------------------------------------------------
+// Eligibility Engine Class Definition
+// Answers "which courses can this student take next?" for whole batches of students.
+//
+// Every course number is given a dense index (catalog courses first, followed by
+// any prerequisites which are not in the catalog).  A set of courses is then a
+// bitset of 64-bit words, so checking whether a student has completed all of a
+// course's prerequisites is one AND-NOT per word instead of a string comparison
+// per prerequisite.  A course only has a few prerequisites, so its requirement
+// bitset is stored sparsely as the (word index, mask) pairs of its non-zero words.
+//
+// Batches are shared out across a pool of worker threads which the engine starts
+// the first time they are needed and keeps until it is destroyed, so a batch does
+// not pay to create and join threads.  Workers steal from each other's share of
+// the batch, so a worker that finishes early keeps helping until it is done.
+// ----------------------------------------------------------------------------------
+class EligibilityEngine {
+
+private:
+
+    // Course number for each dense index
+    std::vector<std::string> courseNumbers;
+    // Dense index for each course number
+    std::map<std::string, unsigned int> courseIndex;
+    // Number of courses which came from the catalog (indices 0 to catalogSize - 1)
+    unsigned int catalogSize;
+    // Number of 64-bit words in each bitset
+    unsigned int wordCount;
+    // The non-zero prerequisite words for catalog course c are entries
+    // requirementStart[c] to requirementStart[c + 1] - 1 of the two vectors below
+    std::vector<uint32_t> requirementStart;
+    // Word index of each non-zero prerequisite word
+    std::vector<uint32_t> requirementWords;
+    // Prerequisite bits within each of those words
+    std::vector<uint64_t> requirementMasks;
+
+    unsigned int indexFor(const std::string& courseNumber);
+    void fillCompletedSet(const std::vector<std::string>& completedCourses, uint64_t* completed);
+    void eligibleForSet(const uint64_t* completed, std::vector<std::string>& eligible);
+
+    // The pool's worker threads (the thread calling EligibleCoursesForBatch is worker 0,
+    // so workers[t - 1] is worker t)
+    std::vector<std::thread> workers;
+    // Only one batch runs at a time
+    std::mutex batchMutex;
+    // Guards the fields below which wake the workers and wait for them
+    std::mutex poolMutex;
+    std::condition_variable batchReady;
+    std::condition_variable batchDone;
+    // Counts batches, so a worker can tell a new batch from one it already worked on
+    uint64_t batchNumber;
+    // Number of workers, including worker 0, taking part in the current batch
+    unsigned int batchThreads;
+    // Number of pool workers still working on the current batch
+    unsigned int busyWorkers;
+    // Set by the destructor to make the workers exit
+    bool stopping;
+    // The current batch's students and results
+    const std::vector<std::vector<std::string>>* batchStudents;
+    std::vector<std::vector<std::string>>* batchResults;
+    // Each worker's remaining range of students, packed as (begin << 32) | end
+    std::vector<std::atomic<uint64_t>> ranges;
+
+    void workerLoop(unsigned int self);
+    void workOnBatch(unsigned int self);
+
+public:
+
+    EligibilityEngine(BinarySearchTree* courses);
+    virtual ~EligibilityEngine();
+    std::vector<uint64_t> MakeCompletedSet(const std::vector<std::string>& completedCourses);
+    std::vector<std::string> EligibleCourses(const std::vector<std::string>& completedCourses);
+    std::vector<std::vector<std::string>> EligibleCoursesForBatch(
+        const std::vector<std::vector<std::string>>& students, unsigned int threadCount = 0);
+};
+
+
+// Constructor for EligibilityEngine class
+// ----------------------------------------
+// Assigns a dense index to every course and prerequisite in the tree and builds the
+// prerequisite bitset for each course.
+//
+// @param courses: a pointer to the loaded binary search tree
+// ----------------------------------------
+EligibilityEngine::EligibilityEngine(BinarySearchTree* courses) {
+
+    // The worker pool starts empty and idle
+    batchNumber = 0;
+    batchThreads = 0;
+    busyWorkers = 0;
+    stopping = false;
+    batchStudents = nullptr;
+    batchResults = nullptr;
+
+    // Copy the courses out of the tree in alphanumeric order
+    std::vector<Course> courseList;
+    courses->CollectCourses(courseList);
+
+    // Give each catalog course an index first so catalog courses are 0 to catalogSize - 1
+    for (unsigned int i = 0; i < courseList.size(); ++i) {
+
+        indexFor(courseList[i].courseNumber);
+    }
+    catalogSize = static_cast<unsigned int>(courseNumbers.size());
+
+    // Then give an index to any prerequisite which is not itself in the catalog
+    for (unsigned int i = 0; i < courseList.size(); ++i) {
+
+        for (unsigned int k = 0; k < courseList[i].coursePrerequisites.size(); ++k) {
+
+            indexFor(courseList[i].coursePrerequisites[k]);
+        }
+    }
+
+    // Every bitset needs one bit per indexed course
+    wordCount = static_cast<unsigned int>((courseNumbers.size() + 63) / 64);
+    if (wordCount == 0) {
+
+        wordCount = 1;
+    }
+
+    // Gather the prerequisite indices for each catalog course
+    // (duplicate course numbers share an index, so this merges their prerequisites)
+    std::vector<std::vector<unsigned int>> prerequisiteIndices(catalogSize);
+
+    for (unsigned int i = 0; i < courseList.size(); ++i) {
+
+        unsigned int course = courseIndex[courseList[i].courseNumber];
+
+        for (unsigned int k = 0; k < courseList[i].coursePrerequisites.size(); ++k) {
+
+            prerequisiteIndices[course].push_back(courseIndex[courseList[i].coursePrerequisites[k]]);
+        }
+    }
+
+    // Store the non-zero words of each course's prerequisite bitset
+    requirementStart.push_back(0);
+
+    for (unsigned int c = 0; c < catalogSize; ++c) {
+
+        std::vector<unsigned int>& indices = prerequisiteIndices[c];
+        std::sort(indices.begin(), indices.end());
+
+        // Sorted indices put the bits for each word next to each other
+        for (unsigned int k = 0; k < indices.size(); ++k) {
+
+            uint32_t word = indices[k] / 64;
+
+            if (k == 0 || requirementWords.back() != word) {
+
+                requirementWords.push_back(word);
+                requirementMasks.push_back(0);
+            }
+
+            requirementMasks.back() |= uint64_t(1) << (indices[k] % 64);
+        }
+
+        requirementStart.push_back(static_cast<uint32_t>(requirementWords.size()));
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// indexFor
+// --------
+// Private method to look up the dense index for a course number, assigning the
+// next free index if the course number has not been seen before.
+//
+// @param courseNumber: the course number to look up
+// ----------------------------------------------------------------------------
+unsigned int EligibilityEngine::indexFor(const std::string& courseNumber) {
+
+    std::map<std::string, unsigned int>::iterator found = courseIndex.find(courseNumber);
+
+    // If we already have an index for this course number, return it
+    if (found != courseIndex.end()) {
+
+        return found->second;
+    }
+
+    // Otherwise assign the next index
+    unsigned int index = static_cast<unsigned int>(courseNumbers.size());
+    courseIndex[courseNumber] = index;
+    courseNumbers.push_back(courseNumber);
+
+    return index;
+}
+
+
+// ----------------------------------------------------------------------------
+// MakeCompletedSet
+// ----------------
+// Public method to turn a list of completed course numbers into a bitset.
+//
+// @param completedCourses: the course numbers a student has completed
+// ----------------------------------------------------------------------------
+std::vector<uint64_t> EligibilityEngine::MakeCompletedSet(const std::vector<std::string>& completedCourses) {
+
+    std::vector<uint64_t> completed(wordCount, 0);
+
+    fillCompletedSet(completedCourses, completed.data());
+
+    return completed;
+}
+
+
+// ----------------------------------------------------------------------------
+// fillCompletedSet
+// ----------------
+// Private method to set the bit for each completed course in an all-zero bitset.
+// Course numbers which are not in the catalog and are not a prerequisite of
+// any catalog course cannot affect eligibility, so they are ignored.
+//
+// @param completedCourses: the course numbers a student has completed
+// @param completed: the bitset to fill (wordCount words, all zero)
+// ----------------------------------------------------------------------------
+void EligibilityEngine::fillCompletedSet(const std::vector<std::string>& completedCourses, uint64_t* completed) {
+
+    for (unsigned int i = 0; i < completedCourses.size(); ++i) {
+
+        // Course numbers are stored in uppercase, so match user input the same way PrintCourseInformation does
+        std::string courseNumber = completedCourses[i];
+        for (unsigned k = 0; k < courseNumber.length(); ++k) {
+
+            courseNumber[k] = toupper(courseNumber[k]);
+        }
+
+        std::map<std::string, unsigned int>::const_iterator found = courseIndex.find(courseNumber);
+
+        if (found != courseIndex.end()) {
+
+            completed[found->second / 64] |= uint64_t(1) << (found->second % 64);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// eligibleForSet
+// --------------
+// Private method to add every catalog course the student has not completed, but
+// has completed all the prerequisites for, to the eligible vector.
+//
+// @param completed: the student's completed set (wordCount words)
+// @param eligible: the vector which eligible course numbers are added to
+// ----------------------------------------------------------------------------
+void EligibilityEngine::eligibleForSet(const uint64_t* completed, std::vector<std::string>& eligible) {
+
+    // For each catalog course, in alphanumeric order
+    for (unsigned int c = 0; c < catalogSize; ++c) {
+
+        // Skip courses the student has already completed
+        if (completed[c / 64] & (uint64_t(1) << (c % 64))) {
+
+            continue;
+        }
+
+        // Any prerequisite bit which is not also a completed bit means a missing prerequisite
+        uint64_t missing = 0;
+
+        for (uint32_t r = requirementStart[c]; r < requirementStart[c + 1] && missing == 0; ++r) {
+
+            missing = requirementMasks[r] & ~completed[requirementWords[r]];
+        }
+
+        if (missing == 0) {
+
+            eligible.push_back(courseNumbers[c]);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// EligibleCourses
+// ---------------
+// Public method to list the courses a single student can take next.
+//
+// @param completedCourses: the course numbers the student has completed
+// ----------------------------------------------------------------------------
+std::vector<std::string> EligibilityEngine::EligibleCourses(const std::vector<std::string>& completedCourses) {
+
+    std::vector<uint64_t> completed = MakeCompletedSet(completedCourses);
+    std::vector<std::string> eligible;
+
+    eligibleForSet(completed.data(), eligible);
+
+    return eligible;
+}
+
+
+// Destructor for EligibilityEngine class
+// ---------------------------------------
+// Stops the worker threads and waits for them to exit.
+// ---------------------------------------
+EligibilityEngine::~EligibilityEngine() {
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    batchReady.notify_all();
+
+    for (unsigned int t = 0; t < workers.size(); ++t) {
+
+        workers[t].join();
+    }
+}
+
+
+// ----------------------------------------------------------------------------------
+// EligibleCoursesForBatch
+// -----------------------
+// Public method to list the courses each student in a batch can take next.
+//
+// The calling thread and up to threadCount - 1 of the pool's workers share the
+// batch, starting any workers the pool does not have yet.  The calling thread
+// works on the batch too, then waits for the pool workers to finish.
+//
+// @param students: the completed course numbers for each student
+// @param threadCount: the number of worker threads (0 uses one per hardware thread)
+// ----------------------------------------------------------------------------------
+std::vector<std::vector<std::string>> EligibilityEngine::EligibleCoursesForBatch(
+    const std::vector<std::vector<std::string>>& students, unsigned int threadCount) {
+
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+
+    std::vector<std::vector<std::string>> results(students.size());
+
+    // Use one worker per hardware thread unless told otherwise
+    if (threadCount == 0) {
+
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+
+        threadCount = 1;
+    }
+    if (threadCount > students.size()) {
+
+        threadCount = students.size() == 0 ? 1 : static_cast<unsigned int>(students.size());
+    }
+
+    // Make room for every worker's range the first time the pool grows
+    if (ranges.size() < threadCount) {
+
+        std::vector<std::atomic<uint64_t>>(threadCount).swap(ranges);
+    }
+
+    // Give each worker an equal share of the students
+    for (unsigned int t = 0; t < threadCount; ++t) {
+
+        uint64_t begin = students.size() * t / threadCount;
+        uint64_t end = students.size() * (t + 1) / threadCount;
+        ranges[t].store((begin << 32) | end);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+
+        // Start any pool workers this batch needs which have not been started yet
+        while (workers.size() + 1 < threadCount) {
+
+            workers.push_back(std::thread(&EligibilityEngine::workerLoop, this,
+                static_cast<unsigned int>(workers.size() + 1)));
+        }
+
+        // Publish the batch and wake the workers
+        batchStudents = &students;
+        batchResults = &results;
+        batchThreads = threadCount;
+        busyWorkers = threadCount - 1;
+        ++batchNumber;
+    }
+    batchReady.notify_all();
+
+    // This thread is worker 0
+    workOnBatch(0);
+
+    // Wait for every pool worker taking part to finish
+    std::unique_lock<std::mutex> lock(poolMutex);
+    batchDone.wait(lock, [this] { return busyWorkers == 0; });
+
+    batchStudents = nullptr;
+    batchResults = nullptr;
+
+    return results;
+}
+
+
+// ----------------------------------------------------------------------------------
+// workerLoop
+// ----------
+// Private method run by each pool worker thread: sleeps until a batch it takes part
+// in is published, works on it, and reports back, until the engine is destroyed.
+//
+// @param self: the worker's number (1 or more)
+// ----------------------------------------------------------------------------------
+void EligibilityEngine::workerLoop(unsigned int self) {
+
+    uint64_t seenBatch = 0;
+    std::unique_lock<std::mutex> lock(poolMutex);
+
+    while (true) {
+
+        batchReady.wait(lock, [&] { return stopping || batchNumber != seenBatch; });
+
+        if (stopping) {
+
+            return;
+        }
+
+        seenBatch = batchNumber;
+
+        // Workers beyond this batch's thread count sit it out
+        if (self >= batchThreads) {
+
+            continue;
+        }
+
+        lock.unlock();
+        workOnBatch(self);
+        lock.lock();
+
+        // The last worker to finish wakes the thread waiting for the batch
+        if (--busyWorkers == 0) {
+
+            batchDone.notify_one();
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------------
+// workOnBatch
+// -----------
+// Private method where a worker works out eligible courses for its share of the
+// current batch.
+//
+// Each worker's share is a [begin, end) range packed into one atomic 64-bit value.
+// A worker takes small chunks from the front of its own range.  Once its range is
+// empty it steals the back half of another worker's range with a compare-and-swap,
+// and it returns once there is nothing left to steal.
+//
+// @param self: the worker's number
+// ----------------------------------------------------------------------------------
+void EligibilityEngine::workOnBatch(unsigned int self) {
+
+    // Number of students a worker takes from its own range at a time
+    const uint32_t chunkSize = 64;
+
+    const std::vector<std::vector<std::string>>& students = *batchStudents;
+    std::vector<std::vector<std::string>>& results = *batchResults;
+    unsigned int threadCount = batchThreads;
+
+    // Reused completed set so each student does not allocate a new one
+    std::vector<uint64_t> completed(wordCount);
+
+    while (true) {
+
+        uint64_t range = ranges[self].load();
+        uint32_t begin = static_cast<uint32_t>(range >> 32);
+        uint32_t end = static_cast<uint32_t>(range);
+
+        // If our own range is empty, try to steal the back half of someone else's
+        if (begin >= end) {
+
+            bool stole = false;
+
+            for (unsigned int offset = 1; offset < threadCount && !stole; ++offset) {
+
+                unsigned int victim = (self + offset) % threadCount;
+                uint64_t victimRange = ranges[victim].load();
+                uint32_t victimBegin = static_cast<uint32_t>(victimRange >> 32);
+                uint32_t victimEnd = static_cast<uint32_t>(victimRange);
+
+                // Keep retrying this victim while it still has students left
+                while (victimBegin < victimEnd) {
+
+                    uint32_t middle = victimBegin + (victimEnd - victimBegin) / 2;
+
+                    // Shrink the victim's range to its front half; on success the back half is ours
+                    if (ranges[victim].compare_exchange_weak(victimRange,
+                            (uint64_t(victimBegin) << 32) | middle)) {
+
+                        ranges[self].store((uint64_t(middle) << 32) | victimEnd);
+                        stole = true;
+                        break;
+                    }
+
+                    victimBegin = static_cast<uint32_t>(victimRange >> 32);
+                    victimEnd = static_cast<uint32_t>(victimRange);
+                }
+            }
+
+            // Nothing left anywhere, so this worker is done
+            if (!stole) {
+
+                return;
+            }
+
+            continue;
+        }
+
+        // Take a chunk from the front of our own range
+        uint32_t chunkEnd = (end - begin > chunkSize) ? begin + chunkSize : end;
+
+        if (!ranges[self].compare_exchange_weak(range, (uint64_t(chunkEnd) << 32) | end)) {
+
+            // A thief changed our range, so look at it again
+            continue;
+        }
+
+        // Work out the eligible courses for each student in the chunk
+        for (uint32_t s = begin; s < chunkEnd; ++s) {
+
+            std::fill(completed.begin(), completed.end(), 0);
+            fillCompletedSet(students[s], completed.data());
+
+            eligibleForSet(completed.data(), results[s]);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------------
+// String Pool Class Definition
+// Stores each distinct string once and hands out a small integer ID for it.
+//
+// Every Intern of a string adds a reference to it, and every Release removes one.
+// When the last reference is released the string is freed and its ID is reused by
+// the next new string.
+// ----------------------------------------------------------------------------------
+class StringPool {
+
+private:
+
+    // Orders string pointers by the strings they point to
+    struct PointerLess {
+        bool operator()(const std::string* a, const std::string* b) const {
+            return *a < *b;
+        }
+    };
+
+    // The strings, indexed by ID (a deque never moves its elements, so pointers stay valid)
+    std::deque<std::string> strings;
+    // Number of references to each ID (0 means the ID is free)
+    std::vector<unsigned int> refCounts;
+    // Look up the ID for a string without storing a second copy of it
+    std::map<const std::string*, uint32_t, PointerLess> ids;
+    // IDs which have been released and can be reused
+    std::vector<uint32_t> freeIds;
+
+public:
+
+    uint32_t Intern(const std::string& value);
+    void Release(uint32_t id);
+    const std::string& Get(uint32_t id) const;
+    unsigned int RefCount(uint32_t id) const;
+    bool Find(const std::string& value, uint32_t& id) const;
+    size_t StringCount() const;
+    static size_t StringBytes(const std::string& value);
+    size_t StringBytesInUse() const;
+    size_t MemoryUsage() const;
+};
+
+
+// ----------------------------------------------------------------------------
+// Intern
+// ------
+// Public method to get the ID for a string, adding it to the pool if needed.
+//
+// @param value: the string to intern
+// @return the ID for the string
+// ----------------------------------------------------------------------------
+uint32_t StringPool::Intern(const std::string& value) {
+
+    // If the string is already in the pool, add a reference and return its ID
+    std::map<const std::string*, uint32_t, PointerLess>::iterator found = ids.find(&value);
+
+    if (found != ids.end()) {
+
+        ++refCounts[found->second];
+        return found->second;
+    }
+
+    // Otherwise store it in a free slot, or at the end of the pool if there are none
+    uint32_t id;
+
+    if (!freeIds.empty()) {
+
+        id = freeIds.back();
+        freeIds.pop_back();
+        strings[id] = value;
+    }
+    else {
+
+        id = static_cast<uint32_t>(strings.size());
+        strings.push_back(value);
+        refCounts.push_back(0);
+    }
+
+    refCounts[id] = 1;
+    ids[&strings[id]] = id;
+
+    return id;
+}
+
+
+// ----------------------------------------------------------------------------
+// Release
+// -------
+// Public method to remove one reference to a string, freeing it when no
+// references are left.
+//
+// @param id: the ID returned by Intern
+// ----------------------------------------------------------------------------
+void StringPool::Release(uint32_t id) {
+
+    if (id >= refCounts.size() || refCounts[id] == 0) {
+
+        return;
+    }
+
+    if (--refCounts[id] == 0) {
+
+        ids.erase(&strings[id]);
+        std::string().swap(strings[id]);
+        freeIds.push_back(id);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// Get
+// ---
+// Public method to look up the string for an ID.
+//
+// @param id: the ID returned by Intern
+// ----------------------------------------------------------------------------
+const std::string& StringPool::Get(uint32_t id) const {
+
+    return strings[id];
+}
+
+
+// ----------------------------------------------------------------------------
+// RefCount
+// --------
+// Public method to get the number of references to an ID.
+//
+// @param id: the ID returned by Intern
+// ----------------------------------------------------------------------------
+unsigned int StringPool::RefCount(uint32_t id) const {
+
+    return (id < refCounts.size()) ? refCounts[id] : 0;
+}
+
+
+// ----------------------------------------------------------------------------
+// Find
+// ----
+// Public method to look up the ID for a string without adding a reference.
+//
+// @param value: the string to look up
+// @param id: set to the string's ID if it is in the pool
+// @return false if the string is not in the pool
+// ----------------------------------------------------------------------------
+bool StringPool::Find(const std::string& value, uint32_t& id) const {
+
+    std::map<const std::string*, uint32_t, PointerLess>::const_iterator found = ids.find(&value);
+
+    if (found == ids.end()) {
+
+        return false;
+    }
+
+    id = found->second;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// StringCount
+// -----------
+// Public method to get the number of distinct strings in the pool.
+// ----------------------------------------------------------------------------
+size_t StringPool::StringCount() const {
+
+    return ids.size();
+}
+
+
+// ----------------------------------------------------------------------------
+// StringBytes
+// -----------
+// Public helper to estimate the bytes used by one stored string: the string
+// object itself plus its heap buffer, if it is too long to fit inside the
+// object (the small string optimization).
+//
+// @param value: the string to measure
+// ----------------------------------------------------------------------------
+size_t StringPool::StringBytes(const std::string& value) {
+
+    const char* buffer = value.data();
+    const char* object = reinterpret_cast<const char*>(&value);
+    bool onHeap = buffer < object || buffer >= object + sizeof(std::string);
+
+    return sizeof(std::string) + (onHeap ? value.capacity() + 1 : 0);
+}
+
+
+// ----------------------------------------------------------------------------
+// StringBytesInUse
+// ----------------
+// Public method to estimate the bytes used by every string which still has a
+// reference (see StringBytes).
+// ----------------------------------------------------------------------------
+size_t StringPool::StringBytesInUse() const {
+
+    size_t bytes = 0;
+
+    for (size_t id = 0; id < strings.size(); ++id) {
+
+        if (refCounts[id] != 0) {
+
+            bytes += StringBytes(strings[id]);
+        }
+    }
+
+    return bytes;
+}
+
+
+// ----------------------------------------------------------------------------
+// MemoryUsage
+// -----------
+// Public method to estimate the bytes used by the whole pool, including the
+// lookup map (counted as three pointers of overhead per map node).
+// ----------------------------------------------------------------------------
+size_t StringPool::MemoryUsage() const {
+
+    size_t bytes = refCounts.capacity() * sizeof(unsigned int) + freeIds.capacity() * sizeof(uint32_t);
+
+    for (size_t id = 0; id < strings.size(); ++id) {
+
+        bytes += StringBytes(strings[id]);
+    }
+
+    bytes += ids.size() * (sizeof(const std::string*) + sizeof(uint32_t) + 3 * sizeof(void*));
+
+    return bytes;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// Catalog Registry Class Definition
+// Holds many named catalogs (for example one per campus and term) in one process.
+//
+// Each catalog is loaded from a csv file, with any edits saved in its edit log, through
+// a BinarySearchTree, then stored as a vector of compact course records sorted by
+// course number.  Course numbers and titles are interned in one StringPool shared by
+// every catalog, and prerequisites are stored as the pool IDs of their course numbers,
+// so a string which appears in several catalogs is only stored once.  Loading or
+// unloading one catalog only adds or releases that catalog's references, so the other
+// catalogs are not affected.
+// ----------------------------------------------------------------------------------
+class CatalogRegistry {
+
+private:
+
+    // A course stored as string pool IDs
+    struct InternedCourse {
+        uint32_t courseNumber;
+        uint32_t name;
+        std::vector<uint32_t> prerequisites;
+    };
+
+    // The string pool shared by every catalog
+    StringPool pool;
+    // The catalogs, by name, each sorted by course number
+    std::map<std::string, std::vector<InternedCourse>> catalogs;
+    // Guards the pool and the catalogs so catalogs can be used from several threads
+    mutable std::mutex registryMutex;
+
+    void releaseCatalog(std::vector<InternedCourse>& catalog);
+    Course toCourse(const InternedCourse& course) const;
+
+public:
+
+    virtual ~CatalogRegistry();
+    bool LoadCatalog(std::string catalogName, std::string csvPath);
+    bool UnloadCatalog(std::string catalogName);
+    bool HasCatalog(std::string catalogName) const;
+    std::vector<std::string> CatalogNames() const;
+    Course Search(std::string catalogName, std::string courseNumber) const;
+    void CollectCourses(std::string catalogName, std::vector<Course>& courseList) const;
+    size_t CatalogMemoryUsage(std::string catalogName, size_t& sharedStringBytes) const;
+    bool StringId(std::string value, uint32_t& id, unsigned int& references) const;
+    size_t StringCount() const;
+    size_t PooledStringBytes() const;
+    void PrintMemoryReport() const;
+};
+
+
+// Destructor
+// ----------
+// Releases every catalog's strings.
+CatalogRegistry::~CatalogRegistry() {
+
+    std::map<std::string, std::vector<InternedCourse>>::iterator it = catalogs.begin();
+
+    for (; it != catalogs.end(); ++it) {
+
+        releaseCatalog(it->second);
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+// LoadCatalog
+// -----------
+// Public method to load a csv file as a named catalog, with any edits saved in its
+// write-ahead log and snapshot applied (read only, so the log files are left as they
+// are).  If a catalog with the same name is already loaded it is replaced once the
+// new one has loaded successfully.
+//
+// @param catalogName: the name to store the catalog under
+// @param csvPath: the file path for the csv file to be loaded
+// @return false if the file could not be loaded or held no courses
+// -----------------------------------------------------------------------------------
+bool CatalogRegistry::LoadCatalog(std::string catalogName, std::string csvPath) {
+
+    // Parse the file, with any edits saved by the menu, into a temporary tree outside the lock
+    std::vector<Course> courseList;
+    {
+        BinarySearchTree courses;
+        WriteAheadLog::LoadWithEdits(&courses, csvPath);
+        courses.CollectCourses(courseList);
+    }
+
+    if (courseList.empty()) {
+
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // Intern every string in the courses (already in course number order)
+    std::vector<InternedCourse> catalog(courseList.size());
+
+    for (size_t i = 0; i < courseList.size(); ++i) {
+
+        catalog[i].courseNumber = pool.Intern(courseList[i].courseNumber);
+        catalog[i].name = pool.Intern(courseList[i].name);
+        catalog[i].prerequisites.reserve(courseList[i].coursePrerequisites.size());
+
+        for (size_t k = 0; k < courseList[i].coursePrerequisites.size(); ++k) {
+
+            catalog[i].prerequisites.push_back(pool.Intern(courseList[i].coursePrerequisites[k]));
+        }
+    }
+
+    // Replace any catalog already loaded under this name
+    std::map<std::string, std::vector<InternedCourse>>::iterator existing = catalogs.find(catalogName);
+
+    if (existing != catalogs.end()) {
+
+        releaseCatalog(existing->second);
+        existing->second.swap(catalog);
+    }
+    else {
+
+        catalogs[catalogName].swap(catalog);
+    }
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// UnloadCatalog
+// -------------
+// Public method to remove a catalog and release its strings.
+//
+// @param catalogName: the name of the catalog to remove
+// @return false if there was no catalog with that name
+// -----------------------------------------------------------------------------------
+bool CatalogRegistry::UnloadCatalog(std::string catalogName) {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::map<std::string, std::vector<InternedCourse>>::iterator found = catalogs.find(catalogName);
+
+    if (found == catalogs.end()) {
+
+        return false;
+    }
+
+    releaseCatalog(found->second);
+    catalogs.erase(found);
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// releaseCatalog
+// --------------
+// Private method to release every string reference held by a catalog.
+//
+// @param catalog: the catalog whose strings are released
+// -----------------------------------------------------------------------------------
+void CatalogRegistry::releaseCatalog(std::vector<InternedCourse>& catalog) {
+
+    for (size_t i = 0; i < catalog.size(); ++i) {
+
+        pool.Release(catalog[i].courseNumber);
+        pool.Release(catalog[i].name);
+
+        for (size_t k = 0; k < catalog[i].prerequisites.size(); ++k) {
+
+            pool.Release(catalog[i].prerequisites[k]);
+        }
+    }
+
+    catalog.clear();
+}
+
+
+// -----------------------------------------------------------------------------------
+// HasCatalog
+// ----------
+// Public method to check whether a catalog is loaded.
+//
+// @param catalogName: the name of the catalog
+// -----------------------------------------------------------------------------------
+bool CatalogRegistry::HasCatalog(std::string catalogName) const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    return catalogs.find(catalogName) != catalogs.end();
+}
+
+
+// -----------------------------------------------------------------------------------
+// CatalogNames
+// ------------
+// Public method to list the names of every loaded catalog in alphabetical order.
+// -----------------------------------------------------------------------------------
+std::vector<std::string> CatalogRegistry::CatalogNames() const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::vector<std::string> names;
+    std::map<std::string, std::vector<InternedCourse>>::const_iterator it = catalogs.begin();
+
+    for (; it != catalogs.end(); ++it) {
+
+        names.push_back(it->first);
+    }
+
+    return names;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Search
+// ------
+// Public method to search a catalog for a course.  Like BinarySearchTree::Search,
+// an empty course is returned if the catalog or course is not found.
+//
+// @param catalogName: the name of the catalog to search
+// @param courseNumber: the courseNumber for the course we're looking for
+// -----------------------------------------------------------------------------------
+Course CatalogRegistry::Search(std::string catalogName, std::string courseNumber) const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::map<std::string, std::vector<InternedCourse>>::const_iterator found = catalogs.find(catalogName);
+
+    if (found != catalogs.end()) {
+
+        const std::vector<InternedCourse>& catalog = found->second;
+
+        // Binary search the sorted catalog for the course number
+        size_t first = 0;
+        size_t last = catalog.size();
+
+        while (first < last) {
+
+            size_t middle = first + (last - first) / 2;
+
+            if (pool.Get(catalog[middle].courseNumber) < courseNumber) {
+
+                first = middle + 1;
+            }
+            else {
+
+                last = middle;
+            }
+        }
+
+        if (first < catalog.size() && pool.Get(catalog[first].courseNumber) == courseNumber) {
+
+            return toCourse(catalog[first]);
+        }
+    }
+
+    // If we didn't find the course, return an empty course
+    Course course;
+    return course;
+}
+
+
+// -----------------------------------------------------------------------------------
+// CollectCourses
+// --------------
+// Public method to copy every course in a catalog into a vector in alphanumeric order.
+//
+// @param catalogName: the name of the catalog
+// @param courseList: the vector which the courses are added to
+// -----------------------------------------------------------------------------------
+void CatalogRegistry::CollectCourses(std::string catalogName, std::vector<Course>& courseList) const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::map<std::string, std::vector<InternedCourse>>::const_iterator found = catalogs.find(catalogName);
+
+    if (found == catalogs.end()) {
+
+        return;
+    }
+
+    for (size_t i = 0; i < found->second.size(); ++i) {
+
+        courseList.push_back(toCourse(found->second[i]));
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+// toCourse
+// --------
+// Private method to turn a compact course record back into a Course object.
+//
+// @param course: the compact course record
+// -----------------------------------------------------------------------------------
+Course CatalogRegistry::toCourse(const InternedCourse& course) const {
+
+    Course result;
+    result.courseNumber = pool.Get(course.courseNumber);
+    result.name = pool.Get(course.name);
+
+    for (size_t k = 0; k < course.prerequisites.size(); ++k) {
+
+        result.coursePrerequisites.push_back(pool.Get(course.prerequisites[k]));
+    }
+
+    return result;
+}
+
+
+// -----------------------------------------------------------------------------------
+// CatalogMemoryUsage
+// ------------------
+// Public method to estimate the memory used by one catalog.
+//
+// The catalog's own records are charged to it in full.  Each pooled string is
+// charged to the catalogs that use it in proportion to their references, so a
+// string shared by four catalogs costs each of them a quarter of its size.
+//
+// @param catalogName: the name of the catalog
+// @param sharedStringBytes: set to this catalog's share of the pooled strings
+// @return the bytes used by the catalog's own records (0 if it is not loaded)
+// -----------------------------------------------------------------------------------
+size_t CatalogRegistry::CatalogMemoryUsage(std::string catalogName, size_t& sharedStringBytes) const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    sharedStringBytes = 0;
+
+    std::map<std::string, std::vector<InternedCourse>>::const_iterator found = catalogs.find(catalogName);
+
+    if (found == catalogs.end()) {
+
+        return 0;
+    }
+
+    const std::vector<InternedCourse>& catalog = found->second;
+    size_t ownBytes = sizeof(std::vector<InternedCourse>) + catalog.capacity() * sizeof(InternedCourse);
+
+    // Count how many references this catalog holds to each string
+    std::map<uint32_t, unsigned int> references;
+
+    for (size_t i = 0; i < catalog.size(); ++i) {
+
+        ownBytes += catalog[i].prerequisites.capacity() * sizeof(uint32_t);
+
+        ++references[catalog[i].courseNumber];
+        ++references[catalog[i].name];
+
+        for (size_t k = 0; k < catalog[i].prerequisites.size(); ++k) {
+
+            ++references[catalog[i].prerequisites[k]];
+        }
+    }
+
+    // Charge this catalog its share of each string it references
+    double sharedBytes = 0.0;
+    std::map<uint32_t, unsigned int>::const_iterator it = references.begin();
+
+    for (; it != references.end(); ++it) {
+
+        sharedBytes += static_cast<double>(StringPool::StringBytes(pool.Get(it->first)))
+            * it->second / pool.RefCount(it->first);
+    }
+
+    sharedStringBytes = static_cast<size_t>(sharedBytes + 0.5);
+
+    return ownBytes;
+}
+
+
+// -----------------------------------------------------------------------------------
+// StringId
+// --------
+// Public method to look up a string in the shared pool, for reports and tests.
+//
+// @param value: the string to look up
+// @param id: set to the string's pool ID
+// @param references: set to the number of references every catalog holds to it
+// @return false if no loaded catalog uses the string
+// -----------------------------------------------------------------------------------
+bool CatalogRegistry::StringId(std::string value, uint32_t& id, unsigned int& references) const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    if (!pool.Find(value, id)) {
+
+        return false;
+    }
+
+    references = pool.RefCount(id);
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+// StringCount
+// -----------
+// Public method to get the number of distinct strings in the shared pool.
+// -----------------------------------------------------------------------------------
+size_t CatalogRegistry::StringCount() const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    return pool.StringCount();
+}
+
+
+// -----------------------------------------------------------------------------------
+// PooledStringBytes
+// -----------------
+// Public method to get the bytes used by the pooled strings, which is what the
+// sharedStringBytes from CatalogMemoryUsage add up to across every catalog.
+// -----------------------------------------------------------------------------------
+size_t CatalogRegistry::PooledStringBytes() const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    return pool.StringBytesInUse();
+}
+
+
+// -----------------------------------------------------------------------------------
+// PrintMemoryReport
+// -----------------
+// Public method to print the memory used by each catalog and by the shared pool.
+// -----------------------------------------------------------------------------------
+void CatalogRegistry::PrintMemoryReport() const {
+
+    std::vector<std::string> names = CatalogNames();
+
+    std::cout << std::endl;
+
+    for (size_t i = 0; i < names.size(); ++i) {
+
+        size_t sharedStringBytes = 0;
+        size_t ownBytes = CatalogMemoryUsage(names[i], sharedStringBytes);
+
+        std::cout << names[i] << ": " << ownBytes << " bytes of course records, "
+            << sharedStringBytes << " bytes share of pooled strings" << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::cout << "String pool: " << pool.StringCount() << " strings, "
+        << pool.StringBytesInUse() << " bytes of strings, "
+        << pool.MemoryUsage() << " bytes in total" << std::endl;
+}
+
+
+// --------------------------------------------------------------
+// The Main Method
+// ---------------
+// The main method for the program. 
+// * Defines the file path for the csv input file
+// * Declares the BinarySearchTree courses pointer 
+// * Initializes the BinarySearchTree courses pointer to nullptr
+// * Declares an empty course object
+// * Calls the MainMenu method
+//
+// The tests in the tests folder include this file directly, so they
+// define COURSE_PLANNER_NO_MAIN to leave this main method out.
 // --------------------------------------------------------------
-// The Main Method
-// ---------------
-// The main method for the program. 
-// * Defines the file path for the csv input file
-// * Declares the BinarySearchTree courses pointer 
-// * Initializes the BinarySearchTree courses pointer to nullptr
-// * Declares an empty course object
-// * Calls the MainMenu method
-// --------------------------------------------------------------
+#ifndef COURSE_PLANNER_NO_MAIN
 int main()
 {
     std::string csvPath = "ABCU_Advising_Program_Input.csv";
@@ -753,4 +3666,5 @@ int main()
     // End program
     return 0;
 }
+#endif
 
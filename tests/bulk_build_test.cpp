@@ -0,0 +1,187 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//  BULK BUILD TEST:
+//  ----------------
+//  Builds the same lists of courses with BinarySearchTree::BulkBuild and with
+//  repeated Insert, and checks that both trees give the same Search result for
+//  every course number (so the first of several duplicate course numbers is the
+//  one found), list the same courses in the same order, and that the bulk built
+//  tree is never taller.  Lists are sorted, reversed, shuffled, and with and
+//  without duplicate course numbers.
+//
+//  Build and run from the repository root:
+//
+//     g++ -O2 -std=c++11 -pthread tests/bulk_build_test.cpp -o bulk_build_test
+//     ./bulk_build_test
+//
+//  Returns 0 if every check passed, otherwise prints the first mismatch and
+//  returns 1.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+#define COURSE_PLANNER_NO_MAIN
+#include "../course_planner.cpp"
+
+#include <algorithm>
+#include <random>
+
+
+// ----------------------------------------------------------------------------
+// sameCourse
+// ----------
+// Checks whether two courses hold the same data.
+//
+// @param a: the first course
+// @param b: the second course
+// ----------------------------------------------------------------------------
+static bool sameCourse(const Course& a, const Course& b) {
+
+    return a.courseNumber == b.courseNumber && a.name == b.name
+        && a.coursePrerequisites == b.coursePrerequisites;
+}
+
+
+// ----------------------------------------------------------------------------
+// minimumHeight
+// -------------
+// The height of a perfectly balanced tree holding a number of courses.
+//
+// @param count: the number of courses
+// ----------------------------------------------------------------------------
+static unsigned int minimumHeight(size_t count) {
+
+    unsigned int levels = 0;
+    while (count > 0) {
+
+        count /= 2;
+        ++levels;
+    }
+
+    return levels;
+}
+
+
+// ----------------------------------------------------------------------------
+// compareBuilds
+// -------------
+// Builds one list of courses both ways and compares the two trees.
+//
+// @param description: what kind of list this is, for the failure message
+// @param courseList: the courses, in the order they would be inserted
+// @param distinct: true if the list has no duplicate course numbers
+// @return true if the trees matched
+// ----------------------------------------------------------------------------
+static bool compareBuilds(const std::string& description, const std::vector<Course>& courseList, bool distinct) {
+
+    BinarySearchTree inserted;
+    for (size_t i = 0; i < courseList.size(); ++i) {
+
+        inserted.Insert(courseList[i]);
+    }
+
+    // BulkBuild sorts its argument, so give it a copy
+    std::vector<Course> bulkList = courseList;
+    BinarySearchTree bulk;
+    bulk.BulkBuild(bulkList);
+
+    // Every course number (and one which is not there) must find the same course
+    for (size_t i = 0; i <= courseList.size(); ++i) {
+
+        std::string courseNumber = (i < courseList.size()) ? courseList[i].courseNumber : "MISSING";
+
+        if (!sameCourse(inserted.Search(courseNumber), bulk.Search(courseNumber))) {
+
+            std::cout << description << ": Search(" << courseNumber << ") differs" << std::endl;
+            return false;
+        }
+    }
+
+    // The in-order listing must be the same, duplicates included
+    std::vector<Course> insertedCourses;
+    std::vector<Course> bulkCourses;
+    inserted.CollectCourses(insertedCourses);
+    bulk.CollectCourses(bulkCourses);
+
+    bool sameListing = insertedCourses.size() == bulkCourses.size();
+    for (size_t i = 0; sameListing && i < insertedCourses.size(); ++i) {
+
+        sameListing = sameCourse(insertedCourses[i], bulkCourses[i]);
+    }
+
+    if (!sameListing) {
+
+        std::cout << description << ": CollectCourses order differs" << std::endl;
+        return false;
+    }
+
+    // The bulk built tree is never taller, and is perfectly balanced without duplicates
+    if (bulk.Height() > inserted.Height() || (distinct && bulk.Height() != minimumHeight(courseList.size()))) {
+
+        std::cout << description << ": bulk height " << bulk.Height() << ", inserted height "
+            << inserted.Height() << ", minimum " << minimumHeight(courseList.size()) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+int main() {
+
+    std::mt19937 random(5);
+    unsigned int lists = 0;
+
+    // Sizes around powers of two, plus the empty and single course lists
+    const size_t sizes[] = { 0, 1, 2, 3, 7, 8, 9, 100, 255, 256, 1000 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+
+        for (int duplicates = 0; duplicates < 2; ++duplicates) {
+
+            // Course numbers are drawn from a smaller range when duplicates are wanted,
+            // and every course gets its own name so duplicates can be told apart
+            std::vector<Course> courseList;
+            for (size_t i = 0; i < sizes[s]; ++i) {
+
+                Course course;
+                unsigned int number = duplicates ? random() % (sizes[s] / 3 + 1) : static_cast<unsigned int>(i);
+                course.courseNumber = "CSCI" + std::to_string(10000 + number);
+                course.name = "Course " + std::to_string(i);
+                if (i % 3 == 0) {
+
+                    course.coursePrerequisites.push_back("MATH" + std::to_string(i));
+                }
+                courseList.push_back(course);
+            }
+
+            std::string size = std::to_string(sizes[s]) + (duplicates ? " courses with duplicates" : " courses");
+
+            // Shuffled, sorted and reversed orders (stable, so duplicates keep their order)
+            std::shuffle(courseList.begin(), courseList.end(), random);
+            if (!compareBuilds("Shuffled " + size, courseList, !duplicates)) {
+
+                return 1;
+            }
+
+            std::stable_sort(courseList.begin(), courseList.end(),
+                [](const Course& a, const Course& b) { return a.courseNumber < b.courseNumber; });
+            if (!compareBuilds("Sorted " + size, courseList, !duplicates)) {
+
+                return 1;
+            }
+
+            std::reverse(courseList.begin(), courseList.end());
+            if (!compareBuilds("Reversed " + size, courseList, !duplicates)) {
+
+                return 1;
+            }
+
+            lists += 3;
+        }
+    }
+
+    std::cout << "BulkBuild matched repeated Insert on " << lists << " lists." << std::endl;
+
+    return 0;
+}
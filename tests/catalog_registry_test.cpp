@@ -0,0 +1,309 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//  CATALOG REGISTRY TEST:
+//  ----------------------
+//  Loads two catalogs which share most of their courses into a CatalogRegistry,
+//  checks Search results, shared string reference counts and how the memory of
+//  the shared strings is charged to each catalog (including the memory report),
+//  unloads one catalog, and checks that the other is untouched and that freed
+//  string IDs are reused.  Last, it loads a catalog with saved edits and checks
+//  they are applied without changing the edit log files.
+//
+//  Build and run from the repository root:
+//
+//     g++ -O2 -std=c++11 -pthread tests/catalog_registry_test.cpp -o catalog_registry_test
+//     ./catalog_registry_test
+//
+//  Creates its csv files in the current directory and removes them at the end.
+//  Returns 0 if every check passed, otherwise prints each failure and returns 1.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+#define COURSE_PLANNER_NO_MAIN
+#include "../course_planner.cpp"
+
+#include <sstream>
+
+
+// Number of failed checks
+static unsigned int failures = 0;
+
+
+// ----------------------------------------------------------------------------
+// check
+// -----
+// Prints a message for a failed check and counts it.
+//
+// @param passed: the result of the check
+// @param description: what was being checked
+// ----------------------------------------------------------------------------
+static void check(bool passed, const std::string& description) {
+
+    if (!passed) {
+
+        std::cout << "FAILED: " << description << std::endl;
+        ++failures;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// writeFile
+// ---------
+// Writes a csv file.
+//
+// @param path: the file path to write
+// @param contents: the contents of the file
+// ----------------------------------------------------------------------------
+static void writeFile(const std::string& path, const std::string& contents) {
+
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << contents;
+}
+
+
+// ----------------------------------------------------------------------------
+// readFile
+// --------
+// Returns the contents of a file (empty if it does not exist).
+//
+// @param path: the file path to read
+// ----------------------------------------------------------------------------
+static std::string readFile(const std::string& path) {
+
+    std::ifstream file(path.c_str(), std::ios::binary);
+
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+
+// ----------------------------------------------------------------------------
+// references
+// ----------
+// Returns the number of references the registry's pool holds to a string
+// (0 if the string is not in the pool).
+//
+// @param registry: the registry to look in
+// @param value: the string to look up
+// ----------------------------------------------------------------------------
+static unsigned int references(const CatalogRegistry& registry, const std::string& value) {
+
+    uint32_t id = 0;
+    unsigned int count = 0;
+
+    return registry.StringId(value, id, count) ? count : 0;
+}
+
+
+// ----------------------------------------------------------------------------
+// expectedShare
+// -------------
+// Works out a catalog's share of the pooled strings: each string's bytes times
+// the catalog's references to it, divided by every catalog's references to it.
+//
+// @param registry: the registry to look in
+// @param catalogReferences: the catalog's references to each string it uses
+// ----------------------------------------------------------------------------
+static double expectedShare(const CatalogRegistry& registry,
+    const std::map<std::string, unsigned int>& catalogReferences) {
+
+    double share = 0.0;
+    std::map<std::string, unsigned int>::const_iterator it = catalogReferences.begin();
+
+    for (; it != catalogReferences.end(); ++it) {
+
+        share += static_cast<double>(StringPool::StringBytes(it->first)) * it->second
+            / references(registry, it->first);
+    }
+
+    return share;
+}
+
+
+// ----------------------------------------------------------------------------
+// closeTo
+// -------
+// Checks whether a rounded byte count is within a byte of the exact share.
+//
+// @param bytes: the rounded byte count
+// @param expected: the exact share
+// ----------------------------------------------------------------------------
+static bool closeTo(size_t bytes, double expected) {
+
+    return static_cast<double>(bytes) > expected - 1.0 && static_cast<double>(bytes) < expected + 1.0;
+}
+
+
+int main() {
+
+    // Two campuses share most courses; each has one course of its own
+    writeFile("registry_test_east.csv",
+        "CSCI100,Introduction to Computer Science\n"
+        "CSCI101,Introduction to Programming in C++,CSCI100\n"
+        "CSCI200,Data Structures,CSCI101\n"
+        "EAST500,East Campus Seminar,CSCI200\n");
+    writeFile("registry_test_west.csv",
+        "CSCI100,Introduction to Computer Science\n"
+        "CSCI101,Introduction to Programming in C++,CSCI100\n"
+        "CSCI200,Data Structures,CSCI101\n"
+        "WEST600,West Campus Studio,CSCI101\n");
+    writeFile("registry_test_north.csv",
+        "NORTH700,North Campus Lab\n");
+
+    CatalogRegistry registry;
+
+    check(registry.LoadCatalog("east", "registry_test_east.csv"), "load east");
+    check(registry.LoadCatalog("west", "registry_test_west.csv"), "load west");
+    check(!registry.LoadCatalog("missing", "registry_test_missing.csv"), "loading a missing file fails");
+
+    // Search works in each catalog and does not see the other catalog's courses
+    Course course = registry.Search("east", "CSCI200");
+    check(course.name == "Data Structures", "east CSCI200 name");
+    check(course.coursePrerequisites.size() == 1 && course.coursePrerequisites[0] == "CSCI101",
+        "east CSCI200 prerequisites");
+    check(registry.Search("west", "WEST600").name == "West Campus Studio", "west WEST600 name");
+    check(registry.Search("east", "WEST600").courseNumber.empty(), "east has no WEST600");
+    check(registry.Search("nowhere", "CSCI100").courseNumber.empty(), "unknown catalog finds nothing");
+
+    // Shared strings are stored once and referenced by both catalogs:
+    // CSCI101 is a course in both (2) and a prerequisite of CSCI200 in both (2) and of WEST600 (1)
+    check(references(registry, "CSCI101") == 5, "CSCI101 has 5 references");
+    check(references(registry, "Data Structures") == 2, "shared name has 2 references");
+    check(references(registry, "East Campus Seminar") == 1, "east-only name has 1 reference");
+
+    // 3 shared course numbers + 3 shared names + 2 own course numbers + 2 own names
+    check(registry.StringCount() == 10, "pool holds 10 distinct strings");
+
+    // Each catalog is charged its share of every string it uses: half of each shared
+    // name, all of its own strings, and its references' share of each course number
+    std::map<std::string, unsigned int> eastReferences;
+    eastReferences["CSCI100"] = 2;
+    eastReferences["Introduction to Computer Science"] = 1;
+    eastReferences["CSCI101"] = 2;
+    eastReferences["Introduction to Programming in C++"] = 1;
+    eastReferences["CSCI200"] = 2;
+    eastReferences["Data Structures"] = 1;
+    eastReferences["EAST500"] = 1;
+    eastReferences["East Campus Seminar"] = 1;
+
+    std::map<std::string, unsigned int> westReferences = eastReferences;
+    westReferences.erase("EAST500");
+    westReferences.erase("East Campus Seminar");
+    westReferences["CSCI200"] = 1;
+    westReferences["CSCI101"] = 3;
+    westReferences["WEST600"] = 1;
+    westReferences["West Campus Studio"] = 1;
+
+    size_t eastShared = 0;
+    size_t westShared = 0;
+    size_t eastOwn = registry.CatalogMemoryUsage("east", eastShared);
+    size_t westOwn = registry.CatalogMemoryUsage("west", westShared);
+
+    check(eastOwn > 0 && westOwn > 0, "both catalogs have their own records");
+    check(closeTo(eastShared, expectedShare(registry, eastReferences)), "east's share of the pooled strings");
+    check(closeTo(westShared, expectedShare(registry, westReferences)), "west's share of the pooled strings");
+
+    // The shares add up to the whole pool (each share is rounded to the nearest byte)
+    size_t pooledBytes = registry.PooledStringBytes();
+    check(eastShared + westShared + 1 >= pooledBytes && eastShared + westShared <= pooledBytes + 1,
+        "shares add up to the pooled string bytes");
+
+    // Remember the IDs of the strings only east uses
+    uint32_t eastNumberId = 0;
+    uint32_t eastNameId = 0;
+    unsigned int count = 0;
+    check(registry.StringId("EAST500", eastNumberId, count), "EAST500 is pooled");
+    check(registry.StringId("East Campus Seminar", eastNameId, count), "east name is pooled");
+
+    // Unloading east releases its references without touching west
+    check(registry.UnloadCatalog("east"), "unload east");
+    check(!registry.UnloadCatalog("east"), "east cannot be unloaded twice");
+    check(!registry.HasCatalog("east"), "east is gone");
+    check(registry.Search("east", "CSCI100").courseNumber.empty(), "east no longer searchable");
+    check(references(registry, "EAST500") == 0, "EAST500 released");
+    check(references(registry, "East Campus Seminar") == 0, "east name released");
+    check(references(registry, "CSCI101") == 3, "CSCI101 down to west's 3 references");
+    check(registry.StringCount() == 8, "pool holds 8 distinct strings");
+
+    course = registry.Search("west", "CSCI200");
+    check(course.name == "Data Structures" && course.coursePrerequisites.size() == 1
+        && course.coursePrerequisites[0] == "CSCI101", "west CSCI200 unchanged");
+
+    // An unloaded catalog costs nothing, and west is now charged for every pooled string
+    eastOwn = registry.CatalogMemoryUsage("east", eastShared);
+    check(eastOwn == 0 && eastShared == 0, "unloaded east reports 0 bytes");
+    westOwn = registry.CatalogMemoryUsage("west", westShared);
+    check(westOwn > 0 && closeTo(westShared, static_cast<double>(registry.PooledStringBytes())),
+        "west is charged for the whole pool");
+
+    // The memory report lists each catalog and the pool
+    std::ostringstream report;
+    std::streambuf* standardOutput = std::cout.rdbuf(report.rdbuf());
+    registry.PrintMemoryReport();
+    std::cout.rdbuf(standardOutput);
+
+    check(report.str().find("west: " + std::to_string(westOwn) + " bytes of course records, "
+        + std::to_string(westShared) + " bytes share of pooled strings") != std::string::npos,
+        "memory report lists west");
+    check(report.str().find("east:") == std::string::npos, "memory report leaves out east");
+    check(report.str().find("String pool: 8 strings, " + std::to_string(registry.PooledStringBytes())
+        + " bytes of strings") != std::string::npos, "memory report lists the pool");
+
+    // A new catalog's new strings reuse the IDs east freed
+    check(registry.LoadCatalog("north", "registry_test_north.csv"), "load north");
+
+    uint32_t northNumberId = 0;
+    uint32_t northNameId = 0;
+    check(registry.StringId("NORTH700", northNumberId, count), "NORTH700 is pooled");
+    check(registry.StringId("North Campus Lab", northNameId, count), "north name is pooled");
+    check((northNumberId == eastNumberId && northNameId == eastNameId)
+        || (northNumberId == eastNameId && northNameId == eastNumberId), "north reuses east's freed IDs");
+    check(registry.StringCount() == 10, "pool back to 10 distinct strings");
+
+    // Replacing a catalog under the same name leaves its reference counts unchanged
+    check(registry.LoadCatalog("west", "registry_test_west.csv"), "reload west");
+    check(references(registry, "CSCI101") == 3, "CSCI101 still has 3 references after reload");
+
+    // A catalog edited through the menu loads with its snapshot and log applied,
+    // including a record cut off at the end of the log, which is skipped
+    writeFile("registry_test_south.csv",
+        "CSCI100,Introduction to Computer Science\n"
+        "CSCI200,Data Structures,CSCI100\n");
+    writeFile("registry_test_south.csv.snapshot", "A,SOUTH700,South Studio\n");
+    writeFile("registry_test_south.csv.wal",
+        "U,CSCI100,Computing Foundations\n"
+        "D,CSCI200\n"
+        "A,SOUTH800,South Seminar,SOUTH700\n"
+        "A,SOUTH9");
+
+    check(registry.LoadCatalog("south", "registry_test_south.csv"), "load south");
+    check(registry.Search("south", "CSCI100").name == "Computing Foundations", "south CSCI100 updated by the log");
+    check(registry.Search("south", "CSCI200").courseNumber.empty(), "south CSCI200 deleted by the log");
+    check(registry.Search("south", "SOUTH700").name == "South Studio", "south SOUTH700 added by the snapshot");
+    course = registry.Search("south", "SOUTH800");
+    check(course.name == "South Seminar" && course.coursePrerequisites.size() == 1
+        && course.coursePrerequisites[0] == "SOUTH700", "south SOUTH800 added by the log");
+    check(registry.Search("south", "SOUTH9").courseNumber.empty(), "south torn record skipped");
+
+    // Loading is read only, so the edit log files are left exactly as they were
+    check(readFile("registry_test_south.csv.wal") == "U,CSCI100,Computing Foundations\nD,CSCI200\n"
+        "A,SOUTH800,South Seminar,SOUTH700\nA,SOUTH9", "south log unchanged");
+    check(readFile("registry_test_south.csv.snapshot") == "A,SOUTH700,South Studio\n", "south snapshot unchanged");
+
+    std::remove("registry_test_east.csv");
+    std::remove("registry_test_west.csv");
+    std::remove("registry_test_north.csv");
+    std::remove("registry_test_south.csv");
+    std::remove("registry_test_south.csv.snapshot");
+    std::remove("registry_test_south.csv.wal");
+
+    if (failures != 0) {
+
+        std::cout << failures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Catalog registry: all checks passed." << std::endl;
+    return 0;
+}
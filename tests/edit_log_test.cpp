@@ -0,0 +1,342 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//  EDIT LOG TEST:
+//  --------------
+//  Makes random adds, updates and deletes through the WriteAheadLog (one commit per
+//  edit in some rounds, group commit with ApplyEdits in others), reloading the
+//  catalog every few dozen edits, and checks that the loaded catalog always equals
+//  the csv file with every edit applied in order.  Along the way it forces
+//  compactions, interrupts a snapshot swap, leaves a torn record at the end of the
+//  log, and edits the csv file by hand.  Last, it leaves a torn record at the end of
+//  the log while compaction is failing, and checks that the next edit survives.
+//
+//  Build and run from the repository root:
+//
+//     g++ -O2 -std=c++11 -pthread tests/edit_log_test.cpp -o edit_log_test
+//     ./edit_log_test
+//
+//  Creates its files in the current directory and removes them when it passes.
+//  Returns 0 if every check passed, otherwise prints the failure and returns 1.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+#define COURSE_PLANNER_NO_MAIN
+#include "../course_planner.cpp"
+
+#include <random>
+
+#if defined(_MSC_VER)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+
+// The csv file used by the test, and the log and snapshot files next to it
+static const std::string csvPath = "edit_log_test.csv";
+
+
+// ----------------------------------------------------------------------------
+// loadedCatalog
+// -------------
+// Returns every course in a tree as csv rows, by course number.
+//
+// @param courses: the tree to read
+// ----------------------------------------------------------------------------
+static std::map<std::string, std::string> loadedCatalog(BinarySearchTree& courses) {
+
+    std::vector<Course> courseList;
+    courses.CollectCourses(courseList);
+
+    std::map<std::string, std::string> catalog;
+    for (size_t i = 0; i < courseList.size(); ++i) {
+
+        catalog[courseList[i].courseNumber] = BinarySearchTree::CourseToCsvRow(courseList[i]);
+    }
+
+    return catalog;
+}
+
+
+// ----------------------------------------------------------------------------
+// writeCsv
+// --------
+// Writes the csv file from a map of csv rows.
+//
+// @param rows: the rows to write, by course number
+// ----------------------------------------------------------------------------
+static void writeCsv(const std::map<std::string, std::string>& rows) {
+
+    std::ofstream csvFile(csvPath.c_str(), std::ios::binary);
+    std::map<std::string, std::string>::const_iterator it = rows.begin();
+
+    for (; it != rows.end(); ++it) {
+
+        csvFile << it->second << "\n";
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// readFile
+// --------
+// Returns the contents of a file (empty if it does not exist).
+//
+// @param path: the file path to read
+// ----------------------------------------------------------------------------
+static std::string readFile(const std::string& path) {
+
+    std::ifstream file(path.c_str(), std::ios::binary);
+
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+
+// ----------------------------------------------------------------------------
+// writeFile
+// ---------
+// Replaces the contents of a file.
+//
+// @param path: the file path to write
+// @param contents: the new contents of the file
+// ----------------------------------------------------------------------------
+static void writeFile(const std::string& path, const std::string& contents) {
+
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << contents;
+}
+
+
+// ----------------------------------------------------------------------------
+// interruptSnapshotSwap
+// ---------------------
+// Compacts the log, then puts the files back the way a crash in the middle of
+// the snapshot swap would leave them: the previous snapshot moved aside to
+// .old, the new snapshot still under its temporary name, and the log not yet
+// emptied.
+//
+// @return false if there was no previous snapshot or the log was empty, so
+//         the swap would not have put anything at risk
+// ----------------------------------------------------------------------------
+static bool interruptSnapshotSwap() {
+
+    std::string previousSnapshot = readFile(csvPath + ".snapshot");
+    std::string previousLog = readFile(csvPath + ".wal");
+
+    {
+        BinarySearchTree courses;
+        WriteAheadLog editLog(csvPath, 4, 0);
+        editLog.Recover(&courses, csvPath);
+        editLog.Compact();
+    }
+
+    std::remove((csvPath + ".snapshot.tmp").c_str());
+    std::rename((csvPath + ".snapshot").c_str(), (csvPath + ".snapshot.tmp").c_str());
+    writeFile(csvPath + ".snapshot.old", previousSnapshot);
+    writeFile(csvPath + ".wal", previousLog);
+
+    return !previousSnapshot.empty() && !previousLog.empty();
+}
+
+
+// ----------------------------------------------------------------------------
+// removeFiles
+// -----------
+// Removes every file the test creates.
+// ----------------------------------------------------------------------------
+static void removeFiles() {
+
+    std::remove(csvPath.c_str());
+    std::remove((csvPath + ".wal").c_str());
+    std::remove((csvPath + ".snapshot").c_str());
+    std::remove((csvPath + ".snapshot.tmp").c_str());
+    std::remove((csvPath + ".snapshot.old").c_str());
+}
+
+
+// ----------------------------------------------------------------------------
+// tornRecordWithFailedCompaction
+// ------------------------------
+// Leaves a torn record at the end of the log and makes compaction fail (the
+// temporary snapshot can't be created because a directory has its name), then
+// adds a course and checks that it is still there after a reload.
+//
+// @return true if the check passed
+// ----------------------------------------------------------------------------
+static bool tornRecordWithFailedCompaction() {
+
+    removeFiles();
+
+    std::map<std::string, std::string> csvRows;
+    csvRows["C1"] = "C1,One";
+    writeCsv(csvRows);
+
+    writeFile(csvPath + ".wal", "A,C2,Two\nA,C99,Tor");
+
+    std::string tempSnapshotPath = csvPath + ".snapshot.tmp";
+#if defined(_MSC_VER)
+    _mkdir(tempSnapshotPath.c_str());
+#else
+    mkdir(tempSnapshotPath.c_str(), 0755);
+#endif
+
+    {
+        // A threshold of 1 makes every load and edit try (and fail) to compact
+        BinarySearchTree courses;
+        WriteAheadLog editLog(csvPath, 4, 1);
+        editLog.Recover(&courses, csvPath);
+
+        Course course;
+        course.courseNumber = "C3";
+        course.name = "Three";
+
+        if (!editLog.Append('A', course) || !editLog.Commit()) {
+
+            std::cout << "Unable to log an edit after a torn record" << std::endl;
+            return false;
+        }
+        courses.ApplyEdit('A', course);
+        editLog.CompactIfNeeded();
+    }
+
+#if defined(_MSC_VER)
+    _rmdir(tempSnapshotPath.c_str());
+#else
+    rmdir(tempSnapshotPath.c_str());
+#endif
+
+    std::map<std::string, std::string> expected = csvRows;
+    expected["C2"] = "C2,Two";
+    expected["C3"] = "C3,Three";
+
+    BinarySearchTree courses;
+    WriteAheadLog editLog(csvPath);
+    editLog.Recover(&courses, csvPath);
+
+    if (loadedCatalog(courses) != expected) {
+
+        std::cout << "An edit appended after a torn record was lost" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+int main() {
+
+    removeFiles();
+    std::mt19937 random(11);
+
+    // The csv rows, and every edit made so far in order
+    std::map<std::string, std::string> csvRows;
+    csvRows["C1"] = "C1,One";
+    csvRows["C2"] = "C2,Two,C1";
+    writeCsv(csvRows);
+
+    std::vector<std::pair<char, Course> > edits;
+
+    for (unsigned int round = 0; round < 40; ++round) {
+
+        // What the catalog should be: the csv file with every edit applied in order
+        std::map<std::string, std::string> expected = csvRows;
+        for (size_t e = 0; e < edits.size(); ++e) {
+
+            if (edits[e].first == 'D') {
+
+                expected.erase(edits[e].second.courseNumber);
+            }
+            else {
+
+                expected[edits[e].second.courseNumber] = BinarySearchTree::CourseToCsvRow(edits[e].second);
+            }
+        }
+
+        BinarySearchTree courses;
+        {
+            // Small thresholds so compaction happens often, except in the rounds
+            // before an interrupted snapshot swap, which need edits left in the log
+            WriteAheadLog editLog(csvPath, 4, (round % 10 == 4) ? 0 : 20);
+            editLog.Recover(&courses, csvPath);
+
+            if (loadedCatalog(courses) != expected) {
+
+                std::cout << "Reloaded catalog is wrong in round " << round << std::endl;
+                return 1;
+            }
+
+            // Make a few dozen random edits
+            std::vector<std::pair<char, Course> > batch;
+
+            for (unsigned int i = 0; i < 30; ++i) {
+
+                Course course;
+                course.courseNumber = "C" + std::to_string(random() % 40);
+                course.name = "Name" + std::to_string(random() % 1000);
+                if (random() % 2 == 0) {
+
+                    course.coursePrerequisites.push_back("C" + std::to_string(random() % 40));
+                }
+
+                unsigned int kind = random() % 3;
+                char operation = (kind == 0) ? 'D' : ((kind == 1) ? 'A' : 'U');
+
+                batch.push_back(std::make_pair(operation, course));
+                edits.push_back(std::make_pair(operation, course));
+            }
+
+            // Alternate between one commit per edit (like the menu) and group commit
+            if (round % 2 == 0) {
+
+                for (size_t i = 0; i < batch.size(); ++i) {
+
+                    if (!editLog.Append(batch[i].first, batch[i].second) || !editLog.Commit()) {
+
+                        std::cout << "Unable to log an edit in round " << round << std::endl;
+                        return 1;
+                    }
+                    courses.ApplyEdit(batch[i].first, batch[i].second);
+                    editLog.CompactIfNeeded();
+                }
+            }
+            else if (editLog.ApplyEdits(&courses, batch) != batch.size()) {
+
+                std::cout << "Unable to log a batch of edits in round " << round << std::endl;
+                return 1;
+            }
+        }
+
+        // Interrupt a snapshot swap: the new snapshot never made it into place
+        if (round % 10 == 4 && !interruptSnapshotSwap()) {
+
+            std::cout << "Nothing at risk in the snapshot swap in round " << round << std::endl;
+            return 1;
+        }
+
+        // Leave a record cut off part way through being written
+        if (round % 7 == 3) {
+
+            std::ofstream logFile((csvPath + ".wal").c_str(), std::ios::app | std::ios::binary);
+            logFile << "A,C99,Torn";
+        }
+
+        // Change the csv file by hand: edit one row and add a new course
+        if (round % 5 == 2) {
+
+            csvRows["C1"] = "C1,One Revised";
+            csvRows["N" + std::to_string(round)] = "N" + std::to_string(round) + ",Added To Csv";
+            writeCsv(csvRows);
+        }
+    }
+
+    if (!tornRecordWithFailedCompaction()) {
+
+        return 1;
+    }
+
+    removeFiles();
+    std::cout << "Edit log matched the expected catalog across 40 reloads." << std::endl;
+
+    return 0;
+}
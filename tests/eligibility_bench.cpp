@@ -0,0 +1,221 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//  ELIGIBILITY BENCHMARK:
+//  ----------------------
+//  Builds a synthetic catalog and a batch of students, checks that the
+//  EligibilityEngine agrees with a plain string-based check (walk every course
+//  and compare its prerequisites), checks that EligibleCoursesForBatch agrees with
+//  EligibleCourses for every student, then reports students/sec.  Finally it runs
+//  many small batches through the same engine, which reuses its worker threads,
+//  and reports batches/sec.
+//
+//  Build and run from the repository root:
+//
+//     g++ -O2 -std=c++11 -pthread tests/eligibility_bench.cpp -o eligibility_bench
+//     ./eligibility_bench [courses] [students]
+//
+//  Defaults to 3000 courses and 40000 students.  Returns 0 if every check passed,
+//  otherwise prints the first mismatch and returns 1.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+#define COURSE_PLANNER_NO_MAIN
+#include "../course_planner.cpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <set>
+
+
+// ----------------------------------------------------------------------------
+// courseNumberFor
+// ---------------
+// Builds the synthetic course number for a course index.
+//
+// @param index: the course index
+// ----------------------------------------------------------------------------
+static std::string courseNumberFor(unsigned int index) {
+
+    return "CRS" + std::to_string(10000 + index);
+}
+
+
+// ----------------------------------------------------------------------------
+// referenceEligible
+// -----------------
+// The check we would have to do without the engine: every course which has not
+// been completed and whose prerequisites have all been completed.
+//
+// @param catalog: every course, in alphanumeric order
+// @param completedCourses: the course numbers the student has completed
+// ----------------------------------------------------------------------------
+static std::vector<std::string> referenceEligible(const std::vector<Course>& catalog,
+    const std::vector<std::string>& completedCourses) {
+
+    std::set<std::string> completed(completedCourses.begin(), completedCourses.end());
+    std::vector<std::string> eligible;
+
+    for (size_t c = 0; c < catalog.size(); ++c) {
+
+        if (completed.count(catalog[c].courseNumber) != 0) {
+
+            continue;
+        }
+
+        bool ready = true;
+        for (size_t k = 0; k < catalog[c].coursePrerequisites.size() && ready; ++k) {
+
+            ready = completed.count(catalog[c].coursePrerequisites[k]) != 0;
+        }
+
+        if (ready) {
+
+            eligible.push_back(catalog[c].courseNumber);
+        }
+    }
+
+    return eligible;
+}
+
+
+// ----------------------------------------------------------------------------
+// timeBatch
+// ---------
+// Runs EligibleCoursesForBatch and returns students/sec.
+//
+// @param engine: the engine to run
+// @param students: the batch of students
+// @param threadCount: the number of worker threads (0 for one per hardware thread)
+// @param results: set to the results of the batch
+// ----------------------------------------------------------------------------
+static double timeBatch(EligibilityEngine& engine, const std::vector<std::vector<std::string>>& students,
+    unsigned int threadCount, std::vector<std::vector<std::string>>& results) {
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    results = engine.EligibleCoursesForBatch(students, threadCount);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return students.size() / elapsed.count();
+}
+
+
+int main(int argc, char* argv[]) {
+
+    unsigned int courseCount = (argc > 1) ? static_cast<unsigned int>(std::atoi(argv[1])) : 3000;
+    unsigned int studentCount = (argc > 2) ? static_cast<unsigned int>(std::atoi(argv[2])) : 40000;
+    std::mt19937 random(7);
+
+    // Each course has up to three prerequisites chosen from earlier courses,
+    // and every so often one which is not in the catalog at all
+    std::vector<Course> courseList;
+    for (unsigned int i = 0; i < courseCount; ++i) {
+
+        Course course;
+        course.courseNumber = courseNumberFor(i);
+        course.name = "Course " + std::to_string(i);
+
+        for (unsigned int k = 0; k < 3 && i > 0; ++k) {
+
+            if (random() % 2 == 0) {
+
+                course.coursePrerequisites.push_back(courseNumberFor(random() % i));
+            }
+        }
+        if (random() % 50 == 0) {
+
+            course.coursePrerequisites.push_back("TRANSFER" + std::to_string(random() % 10));
+        }
+
+        courseList.push_back(course);
+    }
+
+    BinarySearchTree courses;
+    courses.BulkBuild(courseList);
+
+    std::vector<Course> catalog;
+    courses.CollectCourses(catalog);
+
+    EligibilityEngine engine(&courses);
+
+    // Each student has completed a random set of courses, plus the odd transfer credit
+    std::vector<std::vector<std::string>> students(studentCount);
+    for (unsigned int s = 0; s < studentCount; ++s) {
+
+        unsigned int completedCount = random() % 200;
+        for (unsigned int k = 0; k < completedCount; ++k) {
+
+            students[s].push_back(courseNumberFor(random() % courseCount));
+        }
+        if (random() % 4 == 0) {
+
+            students[s].push_back("TRANSFER" + std::to_string(random() % 10));
+        }
+    }
+
+    // The engine must agree with the string-based check (on a sample, since it is slow)
+    for (unsigned int s = 0; s < studentCount; s += 97) {
+
+        if (engine.EligibleCourses(students[s]) != referenceEligible(catalog, students[s])) {
+
+            std::cout << "EligibleCourses disagrees with the string-based check for student " << s << std::endl;
+            return 1;
+        }
+    }
+
+    // The batch must agree with EligibleCourses for every student
+    std::vector<std::vector<std::string>> single(studentCount);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int s = 0; s < studentCount; ++s) {
+
+        single[s] = engine.EligibleCourses(students[s]);
+    }
+    std::chrono::duration<double> singleElapsed = std::chrono::steady_clock::now() - start;
+
+    unsigned int threadCounts[] = { 1, 4, 0 };
+    double rates[3];
+
+    for (unsigned int t = 0; t < 3; ++t) {
+
+        std::vector<std::vector<std::string>> batch;
+        rates[t] = timeBatch(engine, students, threadCounts[t], batch);
+
+        if (batch != single) {
+
+            std::cout << "EligibleCoursesForBatch with " << threadCounts[t]
+                << " threads disagrees with EligibleCourses" << std::endl;
+            return 1;
+        }
+    }
+
+    // Many small batches reuse the pool's worker threads instead of starting new ones
+    const unsigned int smallBatchSize = 64;
+    const unsigned int smallBatchCount = 500;
+    std::vector<std::vector<std::string>> smallBatch(students.begin(),
+        students.begin() + std::min<size_t>(smallBatchSize, students.size()));
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int b = 0; b < smallBatchCount; ++b) {
+
+        std::vector<std::vector<std::string>> smallResults = engine.EligibleCoursesForBatch(smallBatch, 4);
+
+        if (!std::equal(smallResults.begin(), smallResults.end(), single.begin())) {
+
+            std::cout << "Small batch " << b << " disagrees with EligibleCourses" << std::endl;
+            return 1;
+        }
+    }
+    std::chrono::duration<double> smallElapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << courseCount << " courses, " << studentCount << " students: all checks passed." << std::endl;
+    std::cout << "EligibleCourses, one at a time: " << studentCount / singleElapsed.count() << " students/sec" << std::endl;
+    std::cout << "Batch, 1 thread:                " << rates[0] << " students/sec" << std::endl;
+    std::cout << "Batch, 4 threads:               " << rates[1] << " students/sec" << std::endl;
+    std::cout << "Batch, one per hardware thread: " << rates[2] << " students/sec ("
+        << std::thread::hardware_concurrency() << " threads)" << std::endl;
+    std::cout << "Batches of " << smallBatch.size() << ", 4 threads:       " << smallBatchCount / smallElapsed.count()
+        << " batches/sec" << std::endl;
+
+    return 0;
+}
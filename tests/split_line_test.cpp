@@ -0,0 +1,220 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//  SPLIT LINE TEST AND BENCHMARK:
+//  ------------------------------
+//  Checks that BinarySearchTree::SplitLine produces exactly the same cells as the
+//  original character-by-character csv loop, using both the SSE2 and the scalar
+//  mask builders, then reports how many GB/s the original loop and each mask
+//  builder split, both on short lines like the course data (the real load path)
+//  and on one long line.
+//
+//  Build and run from the repository root:
+//
+//     g++ -O2 -std=c++11 -pthread tests/split_line_test.cpp -o split_line_test
+//     ./split_line_test
+//
+//  Returns 0 if every line matched, otherwise prints the first mismatch and
+//  returns 1.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+#define COURSE_PLANNER_NO_MAIN
+#include "../course_planner.cpp"
+
+#include <chrono>
+#include <random>
+
+
+// ----------------------------------------------------------------------------
+// referenceSplit
+// --------------
+// The original LoadData loop: quotes toggle the quoted state and unquoted
+// commas end a cell.
+//
+// @param line: the line of csv data to split
+// @param row: the vector which the cells of data are added to
+// ----------------------------------------------------------------------------
+static void referenceSplit(const std::string& line, std::vector<std::string>& row) {
+
+    bool quoted = false;
+    size_t tokenStart = 0;
+
+    for (size_t i = 0; i != line.length(); i++) {
+
+        if (line.at(i) == '"') {
+
+            quoted = !quoted;
+        }
+        else if (line.at(i) == ',' && !quoted) {
+
+            row.push_back(line.substr(tokenStart, i - tokenStart));
+            tokenStart = i + 1;
+        }
+    }
+
+    row.push_back(line.substr(tokenStart, line.length() - tokenStart));
+}
+
+
+// ----------------------------------------------------------------------------
+// printLine
+// ---------
+// Prints a line with NUL bytes made visible.
+//
+// @param line: the line to print
+// ----------------------------------------------------------------------------
+static void printLine(const std::string& line) {
+
+    for (size_t i = 0; i < line.length(); ++i) {
+
+        if (line[i] == '\0') {
+
+            std::cout << "\\0";
+        }
+        else {
+
+            std::cout << line[i];
+        }
+    }
+    std::cout << std::endl;
+}
+
+
+// ----------------------------------------------------------------------------
+// splitGigabytesPerSecond
+// -----------------------
+// Times splitting every line in a set of lines many times.
+//
+// @param lines: the lines to split
+// @param repeats: the number of times to split the whole set
+// @param reference: true to time the original loop instead of SplitLine
+// ----------------------------------------------------------------------------
+static double splitGigabytesPerSecond(const std::vector<std::string>& lines, unsigned int repeats, bool reference) {
+
+    std::vector<std::string> row;
+    size_t bytes = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned int r = 0; r < repeats; ++r) {
+
+        for (size_t i = 0; i < lines.size(); ++i) {
+
+            row.clear();
+            if (reference) {
+
+                referenceSplit(lines[i], row);
+            }
+            else {
+
+                BinarySearchTree::SplitLine(lines[i], row);
+            }
+            bytes += lines[i].length();
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(bytes) / 1e9 / elapsed.count();
+}
+
+
+// ----------------------------------------------------------------------------
+// printRates
+// ----------
+// Prints GB/s for the original loop and both mask builders on a set of lines.
+//
+// @param title: the description of the lines
+// @param lines: the lines to split
+// @param repeats: the number of times to split the whole set
+// ----------------------------------------------------------------------------
+static void printRates(const std::string& title, const std::vector<std::string>& lines, unsigned int repeats) {
+
+    double referenceRate = splitGigabytesPerSecond(lines, repeats, true);
+    bool haveSimd = BinarySearchTree::SetSimdMasks(true);
+    double simdRate = splitGigabytesPerSecond(lines, repeats, false);
+    BinarySearchTree::SetSimdMasks(false);
+    double scalarRate = splitGigabytesPerSecond(lines, repeats, false);
+    BinarySearchTree::SetSimdMasks(true);
+
+    std::cout << title << std::endl;
+    std::cout << "  Original loop: " << referenceRate << " GB/s" << std::endl;
+    std::cout << "  Scalar masks:  " << scalarRate << " GB/s" << std::endl;
+    if (haveSimd) {
+
+        std::cout << "  SSE2 masks:    " << simdRate << " GB/s" << std::endl;
+    }
+    else {
+
+        std::cout << "  SSE2 masks:    not available in this build" << std::endl;
+    }
+}
+
+
+int main() {
+
+    // Characters for the random lines: quotes, commas and NUL bytes are the ones that matter
+    const char alphabet[] = { 'a', 'b', 'C', '1', ' ', ',', ',', '"', '\0' };
+    std::mt19937 random(2024);
+
+    std::vector<std::string> expected;
+    std::vector<std::string> actual;
+
+    // Compare both mask builders against the reference on random lines of every
+    // length up to a few blocks, so partial and full blocks are both covered
+    for (unsigned int n = 0; n < 200000; ++n) {
+
+        std::string line(random() % 300, ' ');
+        for (size_t i = 0; i < line.length(); ++i) {
+
+            line[i] = alphabet[random() % sizeof(alphabet)];
+        }
+
+        expected.clear();
+        referenceSplit(line, expected);
+
+        for (int simd = 0; simd < 2; ++simd) {
+
+            BinarySearchTree::SetSimdMasks(simd == 1);
+
+            actual.clear();
+            BinarySearchTree::SplitLine(line, actual);
+
+            if (actual != expected) {
+
+                std::cout << "Mismatch (" << (simd == 1 ? "SSE2" : "scalar") << " masks) on line: ";
+                printLine(line);
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "200000 random lines matched the reference with both mask builders." << std::endl;
+
+    // Benchmark on short lines shaped like the course data, which is what LoadData
+    // actually splits: almost all of them fit in a single partial block
+    const char* names[] = { "Introduction to Computer Science", "Data Structures",
+        "\"Algorithms, Part 1\"", "Discrete Mathematics", "Operating Systems" };
+    std::vector<std::string> shortLines;
+    for (unsigned int i = 0; i < 100000; ++i) {
+
+        std::string line = "CSCI" + std::to_string(100 + random() % 400) + "," + names[random() % 5];
+        for (unsigned int k = random() % 3; k > 0; --k) {
+
+            line += ",CSCI" + std::to_string(100 + random() % 400);
+        }
+        shortLines.push_back(line);
+    }
+
+    // And on one long line, where every block but the last is a full block
+    std::vector<std::string> longLine(1);
+    for (unsigned int i = 0; i < 4000; ++i) {
+
+        longLine[0] += "CSCI300,\"Introduction to Algorithms, Part 1\",CSCI200,MATH201,";
+    }
+
+    printRates("Short course lines (100000 lines):", shortLines, 20);
+    printRates("One long line (" + std::to_string(longLine[0].length()) + " bytes):", longLine, 200);
+
+    return 0;
+}